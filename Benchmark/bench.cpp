@@ -0,0 +1,174 @@
+//
+// Created by Florian Claisse on 17/10/2026.
+//
+
+#include <chrono>
+#include <charconv>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../Foundation/include/fasta.h"
+#include "../Foundation/include/fasta_reader.h"
+#include "../Foundation/include/directory.h"
+#include "../Foundation/include/codon.h"
+#include "check.h"
+#include "generator.h"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+/** Largeur de la colonne des noms, le plus long étant « find_contigs (accept 95, prot) » (30 caractères). */
+static const int NAME_WIDTH = 32;
+
+/** Mesure une fonction qui renvoie le nombre de résultats trouvés, puis affiche le débit. */
+template<typename F>
+void run(const string &name, uintmax_t bytes, F &&function) {
+    auto begin(chrono::steady_clock::now());
+    uint64_t hits(function());
+    double seconds(chrono::duration<double>(chrono::steady_clock::now() - begin).count());
+
+    cout << left << setw(NAME_WIDTH) << name << right << fixed << setprecision(3)
+    << setw(12) << seconds
+    << setw(12) << setprecision(1) << ((double) bytes / (1024.0 * 1024.0)) / seconds
+    << setw(14) << setprecision(0) << (double) hits / seconds
+    << setw(12) << hits << endl;
+}
+
+int usage() {
+    cout << "Usage :" << endl
+    << "./contig_bench [--size <Mo>] [--contigs <count>] [--seed <seed>] [--dir <path>] [--line-width <bases>] [--mutation-rate <percentage>]" << endl
+    << "./contig_bench --check <tirages> [--seed <seed>]" << endl
+    << "\t--size\tTaille totale des fichiers cibles générés (4 par défaut)." << endl
+    << "\t--contigs\tNombre de contigs requête (200 par défaut)." << endl
+    << "\t--seed\tGraine du générateur (42 par défaut)." << endl
+    << "\t--dir\tDossier où générer les données (dossier temporaire par défaut)." << endl
+    << "\t--line-width\tLargeur des lignes de séquence des fichiers générés, 0 pour une seule ligne par enregistrement (80 par défaut)." << endl
+    << "\t--mutation-rate\tPourcentage de bases substituées dans les contigs prélevés dans les cibles (2 par défaut)." << endl
+    << "\t--check\tCompare les noyaux SIMD (hamming, packed, Myers) à leurs versions scalaires sur autant de tirages aléatoires, sans mesure." << endl;
+    return EXIT_FAILURE;
+}
+
+int main(int argc, char *argv[]) {
+    vector<string_view> args(argv + 1, argv + argc);
+    if (args.size() % 2 != 0) return usage();
+
+    size_t size(4), contigs(200), rounds(0);
+    generator::Config defaults(generator::default_config(size));
+    size_t line_width(defaults.line_width);
+    double mutation_rate(defaults.mutation_rate * 100.0);
+    uint64_t seed(42);
+    fs::path directory(fs::temp_directory_path() / "contig_bench");
+    for (size_t i = 0; i < args.size(); i += 2) {
+        const string_view &value(args[i + 1]);
+        from_chars_result result{};
+        if (args[i] == "--size") result = from_chars(value.data(), value.data() + value.size(), size);
+        else if (args[i] == "--contigs") result = from_chars(value.data(), value.data() + value.size(), contigs);
+        else if (args[i] == "--seed") result = from_chars(value.data(), value.data() + value.size(), seed);
+        else if (args[i] == "--check") result = from_chars(value.data(), value.data() + value.size(), rounds);
+        else if (args[i] == "--dir") directory = string(value);
+        else if (args[i] == "--line-width") result = from_chars(value.data(), value.data() + value.size(), line_width);
+        else if (args[i] == "--mutation-rate") {
+            result = from_chars(value.data(), value.data() + value.size(), mutation_rate);
+            if (mutation_rate < 0.0 || mutation_rate > 100.0) return usage();
+        }
+        else return usage();
+        if (result.ec == errc::invalid_argument) return usage();
+    }
+    if (rounds > 0) return check::run(rounds, seed);
+
+    generator::Config config(generator::default_config(size));
+    config.contigs = contigs;
+    config.seed = seed;
+    config.line_width = line_width;
+    config.mutation_rate = mutation_rate / 100.0;
+    if (generator::generate(config, directory) != EXIT_SUCCESS) {
+        cout << "Impossible de générer les données dans " << directory << endl;
+        return EXIT_FAILURE;
+    }
+
+    fs::path query(directory / "query.fasta");
+    vector<fs::path> targets;
+    uintmax_t target_bytes(0);
+    for (const auto &file : fs::directory_iterator(directory / "targets")) {
+        if (!fasta::is_fasta_file(file)) continue;
+        targets.push_back(file.path());
+        target_bytes += fs::file_size(file);
+    }
+    sort(targets.begin(), targets.end());
+
+    cout << "Données : " << directory << " (" << target_bytes / (1024 * 1024) << " Mo de cibles, " << contigs << " contigs, " << (line_width == 0 ? string("une ligne par enregistrement") : "lignes de " + to_string(line_width) + " bases") << ", " << mutation_rate << " % de mutations)" << endl;
+    cout << left << setw(NAME_WIDTH) << "benchmark" << right << setw(12) << "s" << setw(12) << "MB/s" << setw(14) << "hits/s" << setw(12) << "hits" << endl;
+
+    run("to_fasta_line", target_bytes, [&targets]() -> uint64_t {
+        for (const auto &target : targets) fasta::to_fasta_line(target);
+        return 0;
+    });
+
+    uintmax_t fastaline_bytes(0);
+    for (const auto &target : targets) fastaline_bytes += fs::file_size(directory::removeExtension(target).append(".fastaline"));
+    run("decode_fastaline", fastaline_bytes, [&targets]() -> uint64_t {
+        uint64_t records(0);
+        for (const auto &target : targets) records += fasta::decode_fastaline(directory::removeExtension(target).append(".fastaline")).size();
+        return records;
+    });
+    for (const auto &target : targets) fs::remove(directory::removeExtension(target).append(".fastaline"));
+
+    auto sequence_file = [](const fs::path &target) -> fs::path { return directory::removeExtension(target).append("." + fasta::SEQUENCE_FILE_EXTENSION); };
+    run("to_sequence_file (2 bits)", target_bytes, [&targets, &sequence_file]() -> uint64_t {
+        for (const auto &target : targets) fasta::to_sequence_file(target, sequence_file(target), true);
+        return 0;
+    });
+
+    uintmax_t sequence_file_bytes(0);
+    for (const auto &target : targets) sequence_file_bytes += fs::file_size(sequence_file(target));
+    run("load_contigs (fastabin)", sequence_file_bytes, [&targets, &sequence_file]() -> uint64_t {
+        uint64_t records(0);
+        for (const auto &target : targets) records += fasta::load_contigs(sequence_file(target)).name_count();
+        return records;
+    });
+    for (const auto &target : targets) fs::remove(sequence_file(target));
+
+    fasta::ContigSet queries(fasta::load_contigs(query));
+
+    run("find_contig (accept 100)", target_bytes, [&]() -> uint64_t {
+        uint64_t hits(0);
+        aho_corasick::Automaton automaton(fasta::build_automaton(queries));
+        for (const auto &target : targets) {
+            fasta::find_contig(target, queries, automaton, true, [&hits](const string&, const string&, const string&) -> void { hits++; });
+        }
+        return hits;
+    });
+
+    for (int accept : {95, 90, 80}) {
+        for (bool nucleic : {true, false}) {
+            string name("find_contigs (accept " + to_string(accept) + (nucleic ? ", nucl)" : ", prot)"));
+            run(name, target_bytes, [&]() -> uint64_t {
+                uint64_t hits(0);
+                for (const auto &target : targets) {
+                    fasta::find_contigs(target, queries, 100 - accept, nucleic, [&hits](const string&, const string&, const string&, double) -> void { hits++; });
+                }
+                return hits;
+            });
+        }
+    }
+
+    run("codon count", target_bytes, [&targets]() -> uint64_t {
+        uint64_t codons(0);
+        for (const auto &target : targets) {
+            fasta::Reader reader(target);
+            fasta::Record record;
+            while (reader.next(record)) {
+                for (size_t frame = 0; frame < 3; frame++) {
+                    codon::Counts counts{};
+                    codon::count(record.sequence, frame, counts);
+                    for (const auto count : counts) codons += count;
+                }
+            }
+        }
+        return codons;
+    });
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,120 @@
+//
+// Created by Florian Claisse on 17/10/2026.
+//
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../Foundation/include/hamming.h"
+#include "../Foundation/include/myers.h"
+#include "../Foundation/include/packed_sequence.h"
+#include "check.h"
+
+using namespace std;
+
+/** Bases tirées au hasard, avec quelques exceptions pour les masques de packed::Sequence. */
+static const char ALPHABET[] = "ACGTACGTACGTACGTACGTACGTNR-";
+
+/** Longueurs aux bords des blocs : 16, 32 et 64 octets pour hamming, 32 bases par mot, 64 lignes par bloc de Myers. */
+static const size_t EDGES[] = {1, 15, 16, 17, 31, 32, 33, 63, 64, 65, 127, 128, 129, 191, 192, 193};
+
+static string random_sequence(mt19937_64 &random, size_t size) {
+    uniform_int_distribution<size_t> letter(0, sizeof(ALPHABET) - 2);
+    string sequence(size, 'A');
+    for (auto &c : sequence) c = ALPHABET[letter(random)];
+    return sequence;
+}
+
+/** Longueur au bord d'un bloc une fois sur deux, quelconque dans [1, max] sinon. */
+static size_t random_length(mt19937_64 &random, size_t max) {
+    if (uniform_int_distribution<int>(0, 1)(random) == 0) {
+        size_t edge(EDGES[uniform_int_distribution<size_t>(0, size(EDGES) - 1)(random)]);
+        if (edge <= max) return edge;
+    }
+    return uniform_int_distribution<size_t>(1, max)(random);
+}
+
+/** Copie de source avec des substitutions, et des insertions et délétions si indels. */
+static string mutate(mt19937_64 &random, const string &source, double rate, bool indels) {
+    uniform_real_distribution<double> chance(0.0, 1.0);
+    uniform_int_distribution<int> kind(0, indels ? 2 : 0);
+    string result;
+    for (const char c : source) {
+        if (chance(random) >= rate) result.push_back(c);
+        else if (int k = kind(random); k == 0) result += random_sequence(random, 1);
+        else if (k == 1) result += random_sequence(random, 1) + c;
+    }
+    return result;
+}
+
+/** Différences limitées à budget + 1 : au-delà du budget, seules les valeurs > budget sont garanties. */
+static size_t capped(size_t error, size_t budget) {
+    return min(error, budget + 1);
+}
+
+static bool check_hamming(mt19937_64 &random) {
+    size_t size(uniform_int_distribution<size_t>(0, 3)(random) == 0 ? 0 : random_length(random, 300));
+    size_t shift_a(uniform_int_distribution<size_t>(0, 63)(random)), shift_b(uniform_int_distribution<size_t>(0, 63)(random));
+    double rate(vector<double>{0.0, 0.02, 0.2, 0.75}[uniform_int_distribution<size_t>(0, 3)(random)]);
+    string a(random_sequence(random, shift_a + size));
+    string b(random_sequence(random, shift_b) + mutate(random, a.substr(shift_a), rate, false));
+    size_t budget(uniform_int_distribution<int>(0, 1)(random) == 0 ? size : uniform_int_distribution<size_t>(0, size)(random));
+
+    size_t expected(capped(hamming::count_scalar(a.data() + shift_a, b.data() + shift_b, size, budget), budget));
+    size_t simd(capped(hamming::count(a.data() + shift_a, b.data() + shift_b, size, budget), budget));
+    packed::Sequence text(a), pattern(string_view(b).substr(shift_b));
+    size_t words(capped(packed::mismatches(text, shift_a, pattern, size, budget), budget));
+    if (simd == expected && words == expected) return true;
+
+    cout << "Écart sur " << size << " bases (décalages " << shift_a << ", " << shift_b << ", budget " << budget << ") : "
+    << "count_scalar " << expected << ", hamming::count (" << hamming::isa() << ") " << simd << ", packed::mismatches " << words << endl;
+    return false;
+}
+
+static bool check_myers(mt19937_64 &random) {
+    string pattern(random_sequence(random, random_length(random, 140)));
+    uniform_int_distribution<size_t> flank(0, 20);
+    string text(random_sequence(random, flank(random)) + mutate(random, pattern, 0.05, true) + random_sequence(random, flank(random)));
+    size_t maxDistance(uniform_int_distribution<size_t>(0, pattern.size() / 4 + 2)(random));
+
+    // Référence : distance de chaque fin, les fins consécutives acceptées sont regroupées sur la première à distance minimale.
+    vector<myers::Hit> reference;
+    size_t first(0);
+    for (size_t end = 1, previous = 0; end <= text.size(); end++) {
+        size_t distance(myers::distance_scalar(text, pattern, end));
+        if (distance > maxDistance) continue;
+        if (first == 0) first = end;
+        if (!reference.empty() && previous + 1 == end) {
+            if (distance < reference.back().distance) reference.back() = {end, distance};
+        }
+        else reference.push_back({end, distance});
+        previous = end;
+    }
+
+    myers::Pattern compiled(pattern);
+    vector<myers::Hit> hits;
+    myers::search(text, compiled, maxDistance, hits);
+    size_t found(myers::find(text, compiled, maxDistance));
+    bool same(hits.size() == reference.size() && found == first);
+    for (size_t i = 0; same && i < hits.size(); i++) same = hits[i].end == reference[i].end && hits[i].distance == reference[i].distance;
+    if (same) return true;
+
+    cout << "Écart myers sur un motif de " << pattern.size() << " bases, texte de " << text.size() << ", distance " << maxDistance << " : "
+    << hits.size() << " occurrences au lieu de " << reference.size() << ", première fin " << found << " au lieu de " << first << endl;
+    return false;
+}
+
+int check::run(size_t rounds, uint64_t seed) {
+    mt19937_64 random(seed);
+    for (size_t i = 0; i < rounds; i++) {
+        if (!check_hamming(random) || !check_myers(random)) {
+            cout << "Tirage " << i << " (graine " << seed << ")." << endl;
+            return EXIT_FAILURE;
+        }
+    }
+    cout << "Vérifications : " << rounds << " tirages sans écart (hamming::count " << hamming::isa() << ")." << endl;
+    return EXIT_SUCCESS;
+}
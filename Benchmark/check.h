@@ -0,0 +1,20 @@
+//
+// Created by Florian Claisse on 17/10/2026.
+//
+
+#ifndef CONTIG_CHECK_H
+#define CONTIG_CHECK_H
+
+#include <cstdint>
+
+namespace check {
+    /**
+     * Compare sur rounds tirages aléatoires les noyaux choisis à l'exécution à leurs versions de référence :
+     * hamming::count et packed::mismatches à hamming::count_scalar, myers::search et myers::find à
+     * myers::distance_scalar. Les longueurs tirées couvrent les fins de bloc SIMD partielles et les motifs de
+     * plus de 64 bases. Affiche le premier écart trouvé et renvoie EXIT_FAILURE, EXIT_SUCCESS sinon.
+     */
+    int run(std::size_t rounds, std::uint64_t seed);
+}
+
+#endif //CONTIG_CHECK_H
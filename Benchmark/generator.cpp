@@ -0,0 +1,79 @@
+//
+// Created by Florian Claisse on 17/10/2026.
+//
+
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "generator.h"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+static const char BASES[] = "ACGT";
+
+generator::Config generator::default_config(size_t size_mb) {
+    Config config;
+    config.seed = 42;
+    config.target_files = 4;
+    config.records = 4;
+    config.record_length = max<size_t>(size_mb, 1) * 1024 * 1024 / (config.target_files * config.records);
+    config.line_width = 80;
+    config.contigs = 1000;
+    config.contig_min = 50;
+    config.contig_max = 500;
+    config.planted = 0.5;
+    config.mutation_rate = 0.02;
+    return config;
+}
+
+/** Écrit un enregistrement en coupant la séquence en lignes de width bases. */
+static void write_record(ofstream &file, const string &name, const string &sequence, size_t width) {
+    file << '>' << name << '\n';
+    if (width == 0) width = max<size_t>(sequence.size(), 1);
+    for (size_t i = 0; i < sequence.size(); i += width) file.write(sequence.data() + i, (streamsize) min(width, sequence.size() - i)) << '\n';
+}
+
+int generator::generate(const Config &config, const fs::path &directory) {
+    mt19937_64 random(config.seed);
+    uniform_int_distribution<int> base(0, 3);
+
+    fs::path targets(directory / "targets");
+    fs::create_directories(targets);
+
+    // Les séquences cibles sont conservées pour y prélever les contigs.
+    vector<string> sequences;
+    for (size_t f = 0; f < config.target_files; f++) {
+        ofstream file((targets / ("target_" + to_string(f) + ".fasta")).string(), ios::trunc);
+        if (!file.is_open()) return EXIT_FAILURE;
+        for (size_t r = 0; r < config.records; r++) {
+            string sequence(config.record_length, 'A');
+            for (auto &c : sequence) c = BASES[base(random)];
+            write_record(file, "target_" + to_string(f) + "_" + to_string(r), sequence, config.line_width);
+            sequences.push_back(move(sequence));
+        }
+    }
+
+    ofstream query((directory / "query.fasta").string(), ios::trunc);
+    if (!query.is_open()) return EXIT_FAILURE;
+    uniform_int_distribution<size_t> length(config.contig_min, config.contig_max);
+    uniform_real_distribution<double> chance(0.0, 1.0);
+    for (size_t c = 0; c < config.contigs; c++) {
+        size_t size(length(random));
+        string contig(size, 'A');
+        if (!sequences.empty() && chance(random) < config.planted) {
+            const string &source(sequences[uniform_int_distribution<size_t>(0, sequences.size() - 1)(random)]);
+            size = min(size, source.size());
+            contig = source.substr(uniform_int_distribution<size_t>(0, source.size() - size)(random), size);
+            for (auto &b : contig) {
+                if (chance(random) < config.mutation_rate) b = BASES[base(random)];
+            }
+        }
+        else for (auto &b : contig) b = BASES[base(random)];
+        write_record(query, "contig_" + to_string(c), contig, config.line_width);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,36 @@
+//
+// Created by Florian Claisse on 17/10/2026.
+//
+
+#ifndef CONTIG_GENERATOR_H
+#define CONTIG_GENERATOR_H
+
+#include <cstdint>
+#include <filesystem>
+
+namespace generator {
+    /** Paramètres du jeu de données synthétique. */
+    typedef struct {
+        std::uint64_t seed;
+        std::size_t target_files;     // nombre de fichiers cibles
+        std::size_t records;          // enregistrements par fichier cible
+        std::size_t record_length;    // bases par enregistrement
+        std::size_t line_width;       // largeur des lignes de séquence, 0 pour une seule ligne
+        std::size_t contigs;          // nombre de contigs requête
+        std::size_t contig_min;
+        std::size_t contig_max;
+        double planted;               // proportion de contigs prélevés dans les cibles
+        double mutation_rate;         // probabilité de substitution par base d'un contig prélevé
+    } Config;
+
+    /** Configuration par défaut, environ size_mb Mo de cibles. */
+    Config default_config(std::size_t size_mb);
+
+    /**
+     * Écrit query.fasta et le dossier targets/ dans directory. Une même configuration produit toujours
+     * exactement les mêmes fichiers. Renvoie EXIT_FAILURE si un fichier ne peut pas être écrit.
+     */
+    int generate(const Config &config, const std::filesystem::path &directory);
+}
+
+#endif //CONTIG_GENERATOR_H
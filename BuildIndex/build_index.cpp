@@ -0,0 +1,26 @@
+//
+// Created by Florian Claisse on 17/10/2026.
+//
+
+#include "../Foundation/include/kmer_index.h"
+#include "build_index.h"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+int build_index::start(const program_option::BuildIndex &options) {
+    if (!fs::is_directory(options.inputB)) {
+        cout << "Path : " << options.inputB << "n'est pas un dossier" << endl;
+        return EXIT_FAILURE;
+    }
+    if (options.k == 0 || options.k > 32 || options.step == 0) {
+        cout << "La taille des k-mers doit être comprise entre 1 et 32 et le pas supérieur à 0." << endl;
+        return EXIT_FAILURE;
+    }
+
+    if (kmer_index::build(options.inputB, options.output, options.k, options.step) != EXIT_SUCCESS) {
+        cout << "Impossible de construire l'index : " << options.output << endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
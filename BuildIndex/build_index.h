@@ -0,0 +1,14 @@
+//
+// Created by Florian Claisse on 17/10/2026.
+//
+
+#ifndef CONTIG_BUILD_INDEX_H
+#define CONTIG_BUILD_INDEX_H
+
+#include "../Foundation/include/program_option.h"
+
+namespace build_index {
+    int start(const program_option::BuildIndex &options);
+}
+
+#endif //CONTIG_BUILD_INDEX_H
@@ -0,0 +1,49 @@
+//
+// Created by Florian Claisse on 17/10/2026.
+//
+
+#include <algorithm>
+
+#include "../Foundation/include/fasta.h"
+#include "../Foundation/include/directory.h"
+#include "convert.h"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+int convert::start(const program_option::Convert &options) {
+    if (!fs::is_directory(options.output)) {
+        cout << "Path : " << options.output << "n'est pas un dossier" << endl;
+        return EXIT_FAILURE;
+    }
+
+    // Les conteneurs ne sont pas écrits à côté de leurs fichiers fasta, qui seraient sinon deux copies des mêmes enregistrements.
+    fs::path inputDirectory(fs::is_directory(options.inputB) ? options.inputB : fs::absolute(options.inputB).parent_path());
+    if (fs::equivalent(inputDirectory, options.output)) {
+        cout << "Le dossier de sortie doit être différent du dossier des fichiers fasta : " << options.output << endl;
+        return EXIT_FAILURE;
+    }
+
+    // Les conteneurs déjà convertis ne sont pas repris.
+    vector<fs::path> files;
+    if (fs::is_directory(options.inputB)) {
+        for (const auto &currentFile : fs::directory_iterator(options.inputB)) {
+            if (fasta::is_fasta_file(currentFile)) files.push_back(currentFile.path());
+        }
+    }
+    else if (fasta::is_fasta_file(options.inputB)) files.push_back(options.inputB);
+    else {
+        cout << "Path : " << options.inputB << "n'est pas un dossier ou un fichier fasta" << endl;
+        return EXIT_FAILURE;
+    }
+    sort(files.begin(), files.end());
+
+    for (const auto &file : files) {
+        fs::path output(options.output.string().append("/" + directory::fileNameWithoutExtension(file) + "." + fasta::SEQUENCE_FILE_EXTENSION));
+        if (fasta::to_sequence_file(file, output, options.packed) != EXIT_SUCCESS) {
+            cout << "Impossible de convertir : " << file << endl;
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
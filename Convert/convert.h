@@ -0,0 +1,14 @@
+//
+// Created by Florian Claisse on 17/10/2026.
+//
+
+#ifndef CONTIG_CONVERT_H
+#define CONTIG_CONVERT_H
+
+#include "../Foundation/include/program_option.h"
+
+namespace convert {
+    int start(const program_option::Convert &options);
+}
+
+#endif //CONTIG_CONVERT_H
@@ -3,21 +3,30 @@
 //
 
 #include <fstream>
+#include <algorithm>
+#include <charconv>
+#include <mutex>
 #include "../Foundation/include/fasta.h"
+#include "../Foundation/include/fasta_search.h"
 #include "../Foundation/include/directory.h"
+#include "../Foundation/include/thread_pool.h"
+#include "../Foundation/include/kmer_index.h"
+#include "../Foundation/include/stats.h"
+#include "../Foundation/include/result_writer.h"
+#include "../Foundation/include/result_cache.h"
 #include "find_all.h"
 
 using namespace std;
 namespace fs = std::filesystem;
 
 int check_options(const program_option::FindAll &options) {
-    if (!fasta::is_fasta_file(options.inputA)) {
+    if (!fasta::is_input_file(options.inputA)) {
         cout << "Le fichier : " << options.inputA <<  "n'est pas un fichier fasta." << endl;
         return EXIT_FAILURE;
     }
 
-    if (!fs::is_directory(options.inputB)) {
-        cout << "Path : " << options.inputB << "n'est pas un dossier" << endl;
+    if (!fs::is_directory(options.inputB) && !fasta::is_input_file(options.inputB)) {
+        cout << "Path : " << options.inputB << "n'est pas un dossier ou un fichier fasta" << endl;
         return EXIT_FAILURE;
     }
 
@@ -29,67 +38,392 @@ int check_options(const program_option::FindAll &options) {
     return EXIT_SUCCESS;
 }
 
+/** Taille à partir de laquelle un lot de résultats est confié au writer. */
+static const size_t BATCH_SIZE = 1 << 20;
+
+/** Ajoute un pourcentage au lot, avec le même format que l'opérateur << d'un flux (%g, 6 chiffres). */
+static void append_number(string &batch, double value) {
+    char buffer[32];
+    auto result = to_chars(buffer, buffer + sizeof(buffer), value, chars_format::general, 6);
+    batch.append(buffer, result.ptr);
+}
+
+/** Entrée du cache pour un fichier du dossier B : clé (vide sans cache) et résultat repris du cache ou non. */
+struct CacheEntry {
+    string key;
+    bool hit = false;
+};
+
+/** Chemin du fichier résultat d'un fichier du dossier B. */
+static fs::path result_path(const program_option::FindAll &options, const fs::path &file) {
+    return options.output.string().append("/" + directory::fileNameWithoutExtension(file) + "-result.fasta");
+}
+
+/**
+ * Traite un fichier du dossier B : recherche des contigs et écriture de son fichier résultat. Renvoie la ligne de output.txt.
+ * Avec pool, les grandes séquences sont découpées entre ses workers (recherche exacte et avec substitutions seulement).
+ * Si le cache a une entrée pour le fichier, sa ligne et son fichier résultat sont repris sans recherche.
+ */
+string scan_file(const program_option::FindAll &options, const fs::path &file, const fasta::ContigSet &contigs, const aho_corasick::Automaton &automaton, const fasta::SeedFilter &filter, const kmer_index::Index *index, size_t file_number, size_t window, ThreadPool *pool, const ResultCache &cache, CacheEntry &entry, ResultWriter &writer, stats::Report *report) {
+    stats::Stopwatch timer;
+    stats::Counters &counters(stats::local());
+    counters = stats::Counters();
+    counters.bytes = fs::file_size(file);
+
+    string fileNameWithoutExtension(directory::fileNameWithoutExtension(file));
+    string row(fileNameWithoutExtension + "\t");
+
+    if (cache.is_open()) {
+        string cached;
+        entry.key = cache.key(file);
+        entry.hit = cache.load(entry.key, cached, result_path(options, file));
+        if (entry.hit) {
+            if (report != nullptr) report->add_file({directory::fileName(file), timer.elapsed(), counters});
+            return row + cached;
+        }
+    }
+
+    ResultWriter::Output currentOutputResult(writer.open(result_path(options, file)));
+    string batch;
+    batch.reserve(BATCH_SIZE + 4096);
+
+    // Le brin n'est écrit que si les deux brins sont cherchés, la sortie du brin direct seul est inchangée.
+    // En recherche traduite, le cadre de lecture et les bases de l'occurrence (begin..end) sont écrits après le contig.
+    auto write_hit = [&](string_view nameA, string_view nameB, string_view value, double percentage, char strand, size_t end, size_t distance, int frame, size_t begin) -> void {
+        counters.hits++;
+        row += nameA;
+        row += '\t';
+        batch += nameB;
+        batch += " -> ";
+        batch += nameA;
+        if (options.both_strands) {
+            batch += " (";
+            batch += strand;
+            batch += ")";
+        }
+        if (options.translate) {
+            batch += " -> cadre ";
+            if (frame > 0) batch += '+';
+            batch += to_string(frame);
+            batch += " (";
+            batch += to_string(begin);
+            batch += "..";
+            batch += to_string(end);
+            batch += ")";
+        }
+        if (options.accept != 100) {
+            batch += " -> ";
+            append_number(batch, 100.0 - percentage);
+            batch += "%";
+            if (options.indels) {
+                batch += " -> fin ";
+                batch += to_string(end);
+                batch += " (";
+                batch += to_string(distance);
+                batch += distance > 1 ? " éditions)" : " édition)";
+            }
+        }
+        batch += '\n';
+        batch += value;
+        batch += '\n';
+
+        if (batch.size() >= BATCH_SIZE) {
+            writer.write(currentOutputResult, move(batch));
+            batch = string();
+            batch.reserve(BATCH_SIZE + 4096);
+        }
+    };
+    auto substitution_hit = [&write_hit](string_view nameA, string_view nameB, string_view value, double percentage, char strand) -> void {
+        write_hit(nameA, nameB, value, percentage, strand, 0, 0, 0, 0);
+    };
+
+    if (index != nullptr) {
+        // L'index fournit les positions candidates, vérifiées sur la séquence du fichier.
+        kmer_index::find_contigs(*index, file_number, file, contigs, (100 - options.accept), options.both_strands, substitution_hit);
+    }
+    else if (options.translate) {
+        auto translated_hit = [&write_hit](string_view nameA, string_view nameB, string_view value, double percentage, int frame, size_t begin, size_t end) -> void {
+            write_hit(nameA, nameB, value, percentage, '+', end, 0, frame, begin);
+        };
+        if (options.accept == 100) fasta::find_translated<true>(file, contigs, automaton, filter, translated_hit);
+        else fasta::find_translated<false>(file, contigs, automaton, filter, translated_hit);
+    }
+    else if (options.accept == 100) {
+        auto exact_hit = [&write_hit](string_view nameA, string_view nameB, string_view value, char strand) -> void {
+            write_hit(nameA, nameB, value, 0.0, strand, 0, 0, 0, 0);
+        };
+        if (options.nucl) fasta::find_exact<true>(file, contigs, automaton, options.both_strands, exact_hit, window, pool);
+        else fasta::find_exact<false>(file, contigs, automaton, options.both_strands, exact_hit, window, pool);
+    }
+    else if (options.indels) {
+        auto edit_hit = [&write_hit](string_view nameA, string_view nameB, string_view value, double percentage, char strand, size_t end, size_t distance) -> void {
+            write_hit(nameA, nameB, value, percentage, strand, end, distance, 0, 0);
+        };
+        if (options.nucl) fasta::find_edit<true>(file, contigs, (100 - options.accept), options.both_strands, edit_hit);
+        else fasta::find_edit<false>(file, contigs, (100 - options.accept), false, edit_hit);
+    }
+    else if (options.best != 0) {
+        // Les meilleures occurrences sont choisies sur tout le fichier, qui n'est pas découpé entre les workers.
+        if (options.nucl) fasta::find_best<true>(file, contigs, filter, options.best, substitution_hit, window);
+        else fasta::find_best<false>(file, contigs, filter, options.best, substitution_hit, window);
+    }
+    else if (options.nucl) fasta::find_seeded<true>(file, contigs, filter, substitution_hit, window, pool);
+    else fasta::find_seeded<false>(file, contigs, filter, substitution_hit, window, pool);
+
+    writer.write(currentOutputResult, move(batch));
+    writer.close(currentOutputResult);
+    if (report != nullptr) report->add_file({directory::fileName(file), timer.elapsed(), counters});
+    return row + "\n";
+}
+
+/**
+ * Mode présence : chaque contig n'est cherché que jusqu'à sa première occurrence. Renvoie la colonne du fichier dans la matrice.
+ * L'entrée du cache garde la colonne sous forme de '1' et de '0', dans l'ordre des séquences de l'ensemble.
+ */
+vector<bool> presence_file(const program_option::FindAll &options, const fs::path &file, const fasta::ContigSet &contigs, const aho_corasick::Automaton &automaton, const kmer_index::Index *index, size_t file_number, size_t window, const ResultCache &cache, CacheEntry &entry, stats::Report *report) {
+    stats::Stopwatch timer;
+    stats::Counters &counters(stats::local());
+    counters = stats::Counters();
+    counters.bytes = fs::file_size(file);
+
+    vector<bool> found;
+    if (cache.is_open()) {
+        string cached;
+        entry.key = cache.key(file);
+        entry.hit = cache.load(entry.key, cached, fs::path()) && cached.size() == contigs.size();
+        if (entry.hit) {
+            for (char bit : cached) found.push_back(bit == '1');
+            counters.hits = (uint64_t) count(found.begin(), found.end(), true);
+            if (report != nullptr) report->add_file({directory::fileName(file), timer.elapsed(), counters});
+            return found;
+        }
+    }
+
+    if (index != nullptr) kmer_index::find_presence(*index, file_number, file, contigs, (100 - options.accept), options.both_strands, found);
+    else if (options.accept == 100) fasta::find_presence(file, contigs, automaton, found, window);
+    else if (options.indels) fasta::find_edit_presence(file, contigs, (100 - options.accept), options.both_strands, found);
+    else fasta::find_presence(file, contigs, (100 - options.accept), options.nucl, options.both_strands, found);
+
+    counters.hits = (uint64_t) count(found.begin(), found.end(), true);
+    if (report != nullptr) report->add_file({directory::fileName(file), timer.elapsed(), counters});
+    return found;
+}
+
+/** Matrice de présence au format TSV : une ligne par contig (ordre alphabétique, sans le '>'), une colonne par fichier du dossier B. */
+static string presence_matrix(const fasta::ContigSet &contigs, const vector<fs::path> &files, const vector<vector<bool>> &columns) {
+    vector<pair<string_view, size_t>> names;
+    names.reserve(contigs.name_count());
+    for (size_t contig = 0; contig < contigs.size(); contig++) {
+        for (size_t n = contigs.names_begin(contig); n < contigs.names_end(contig); n++) names.emplace_back(contigs.name(n), contig);
+    }
+    sort(names.begin(), names.end());
+
+    string content("Contig");
+    for (const auto &file : files) content += "\t" + directory::fileNameWithoutExtension(file);
+    content += '\n';
+    for (const auto &name : names) {
+        content += name.first.substr(name.first.empty() || name.first[0] != '>' ? 0 : 1);
+        for (const auto &column : columns) content += column[name.second] ? "\t1" : "\t0";
+        content += '\n';
+    }
+    return content;
+}
+
+/** Identifie la recherche pour le cache : contenu du fichier A et options qui changent le résultat d'un fichier. */
+static string cache_search(const program_option::FindAll &options) {
+    string search(ResultCache::file_fingerprint(options.inputA));
+    search += options.nucl ? " " NUCLEIC : " " PROTEIN;
+    search += " " ACCEPT " " + to_string(options.accept);
+    search += options.both_strands ? " " STRAND " " BOTH : " " STRAND " " FORWARD;
+    search += options.indels ? " " INDELS " " ON : " " INDELS " " OFF;
+    search += options.translate ? " " TRANSLATE " " ON : " " TRANSLATE " " OFF;
+    if (!options.index.empty()) search += " " INDEX;
+    if (!options.presence.empty()) search += " " PRESENCE;
+    if (options.best != 0) search += " " BEST " " + to_string(options.best);
+    return search;
+}
+
 int find_all::start(const program_option::FindAll &options) {
+    if (!options.serve.empty()) return serve(options);
     if (check_options(options) != EXIT_SUCCESS) return EXIT_FAILURE;
 
-    if (fasta::to_fasta_line(options.inputA) != EXIT_SUCCESS) return EXIT_FAILURE;
+    unique_ptr<stats::Report> report;
+    if (!options.stats.empty()) report = make_unique<stats::Report>(FINDALL);
 
-    // Convert directory fasta to fastaline
-    for (const auto &currentFile : fs::directory_iterator(options.inputB)) {
-        if (!fasta::is_fasta_file(currentFile)) continue;
-        if (fasta::to_fasta_line(currentFile) != EXIT_SUCCESS) return EXIT_FAILURE;
-    }
+    unique_ptr<Query> query(prepare(options, report.get()));
+    return run(options, *query, report.get(), nullptr);
+}
 
-    // Stocker les contigs du fichier de test dans un tableau.
-    string inputPath(directory::removeExtension(options.inputA).append(".fastaline"));
-    ifstream inputFile;
-    inputFile.open(inputPath);
+unique_ptr<find_all::Query> find_all::prepare(const program_option::FindAll &options, stats::Report *report) {
+    // Stocker les contigs du fichier de test dans un tableau. Le filtre est construit sur les contigs déjà en place.
+    unique_ptr<Query> prepared(make_unique<Query>());
+    Query &query(*prepared);
+    {
+        stats::ScopedTimer timer(report, "load_contigs");
+        query.contigs = fasta::load_contigs(options.inputA);
+    }
 
-    string name;
-    string value;
-    map<string, string> contigs;
-    while(!inputFile.eof()) {
-        getline(inputFile, name);
-        getline(inputFile, value);
-        contigs[name] = value;
+    // L'automate est construit une seule fois pour tous les fichiers du dossier B.
+    if (options.accept == 100 && options.index.empty()) {
+        stats::ScopedTimer timer(report, "build_automaton");
+        query.automaton = fasta::build_automaton(query.contigs, options.both_strands);
     }
-    for (const auto &contig_value: contigs) {
-        cout << "Value : " << contig_value.first << ", name : " << contig_value.second << endl << endl;
+    // De même pour le filtre par graines de la recherche avec différences. En mode serveur, une recherche peut ne pas être en mode présence.
+    if (options.accept != 100 && !options.indels && options.index.empty() && (options.presence.empty() || !options.serve.empty())) {
+        stats::ScopedTimer timer(report, "build_filter");
+        query.filter = fasta::SeedFilter(query.contigs, (100 - options.accept), options.both_strands);
     }
-    inputFile.close();
+    return prepared;
+}
+
+int find_all::run(const program_option::FindAll &options, const Query &query, stats::Report *report, const LineSink &emit) {
+    const fasta::ContigSet &contigs(query.contigs);
+    const aho_corasick::Automaton &automaton(query.automaton);
+    const fasta::SeedFilter &filter(query.filter);
 
-    ofstream outputFile;
-    outputFile.open(options.output.string().append("/output.txt"), ios::trunc);
-    outputFile << "Filename\t\n";
+    // Les fichiers sont triés par nom : c'est l'ordre des lignes de output.txt, quel que soit le nombre de threads.
+    vector<fs::path> files;
+    if (fs::is_directory(options.inputB)) files = fasta::input_files(options.inputB);
+    else files.push_back(options.inputB);
+    vector<string> rows(files.size());
+    vector<vector<bool>> columns(files.size());
+    bool presence(!options.presence.empty());
+    ResultWriter writer;
 
-    for (const auto &file : filesystem::directory_iterator(options.inputB)) {
-        if (!fasta::is_fastaline_file(file)) continue;
+    // Les fichiers déjà traités par une recherche identique sont repris du cache.
+    ResultCache cache;
+    if (!options.cache.empty()) cache = ResultCache(options.cache, cache_search(options));
+    vector<CacheEntry> entries(files.size());
+
+    // Les fichiers de l'index sont rangés dans ce même ordre.
+    unique_ptr<kmer_index::Index> index;
+    if (!options.index.empty()) {
+        if (!options.nucl) {
+            cout << "L'index ne peut être utilisé qu'avec le type " << NUCLEIC << "." << endl;
+            return EXIT_FAILURE;
+        }
+        index = make_unique<kmer_index::Index>(options.index);
+        if (!index->is_valid()) {
+            cout << "Le fichier : " << options.index << " n'est pas un index valide." << endl;
+            return EXIT_FAILURE;
+        }
+        if (!index->is_current(options.inputB)) {
+            cout << "L'index ne correspond plus au dossier " << options.inputB << ", il doit être reconstruit avec " << BUILDINDEX << "." << endl;
+            return EXIT_FAILURE;
+        }
+    }
 
-        string fileNameWithoutExtension(directory::fileNameWithoutExtension(file.path()));
-        ofstream currentOutputResult;
-        currentOutputResult.open(options.output.string().append("/" + fileNameWithoutExtension + "-result.fasta"), ios::trunc);
+    // Les lignes de output.txt sont transmises dans l'ordre des fichiers, dès que tous les fichiers précédents sont traités.
+    mutex emitMutex;
+    vector<bool> done(files.size());
+    size_t emitted(0);
+    auto publish = [&](size_t current) -> void {
+        if (!emit) return;
+        lock_guard<mutex> lock(emitMutex);
+        done[current] = true;
+        for (; emitted < files.size() && done[emitted]; emitted++) emit(rows[emitted]);
+    };
+    if (emit && !presence) emit("Filename\t\n");
 
-        outputFile << directory::fileNameWithoutExtension(file.path()) << "\t";
+    {
+        stats::ScopedTimer timer(report, "scan");
 
-        if (options.accept == 100) {
-            fasta::find_contig(file.path(), contigs, options.nucl, [&outputFile, &currentOutputResult](const string &nameA, const string &nameB, const string &value) -> void {
-                outputFile << nameA << "\t";
-                currentOutputResult << nameB << " -> " << nameA << endl << value << endl;
+        // Les plus gros fichiers sont soumis en premier pour équilibrer la charge entre les workers.
+        vector<size_t> order(files.size());
+        vector<uintmax_t> sizes(files.size());
+        uintmax_t total(0);
+        for (size_t i = 0; i < order.size(); i++) {
+            order[i] = i;
+            sizes[i] = fs::file_size(files[i]);
+            total += sizes[i];
+        }
+        stable_sort(order.begin(), order.end(), [&sizes](size_t a, size_t b) -> bool { return sizes[a] > sizes[b]; });
+
+        // Si le plus gros fichier dépasse la part d'un worker, répartir les fichiers ne peut pas occuper tous les threads :
+        // ils sont alors traités l'un après l'autre, chaque grande séquence étant découpée entre les workers.
+        bool split(!presence && index == nullptr && !(options.indels && options.accept != 100) && !options.translate && options.best == 0 && options.threads > 1
+                   && !files.empty() && sizes[order[0]] * options.threads > total);
+
+        // Le budget mémoire est partagé entre les workers, chacun lit ses enregistrements par fenêtres de cette taille.
+        size_t workers(split ? options.threads : min<size_t>(options.threads, max<size_t>(files.size(), 1)));
+        size_t window(options.max_memory / (split ? 1 : workers));
+        if (options.max_memory != 0 && !contigs.empty() && window < 2 * contigs.length(contigs.size() - 1)) {
+            cout << "Le budget de " << MAXMEMORY << " est trop petit : il faut au moins " << 2 * contigs.length(contigs.size() - 1) << " octets par thread." << endl;
+            return EXIT_FAILURE;
+        }
+
+        ThreadPool pool(workers);
+        if (split) {
+            for (size_t current = 0; current < files.size(); current++) {
+                rows[current] = scan_file(options, files[current], contigs, automaton, filter, nullptr, current, window, &pool, cache, entries[current], writer, report);
+                publish(current);
+            }
+        }
+        else for (size_t current : order) {
+            if (presence) pool.submit([&, current]() -> void { columns[current] = presence_file(options, files[current], contigs, automaton, index.get(), current, window, cache, entries[current], report); });
+            else pool.submit([&, current]() -> void {
+                rows[current] = scan_file(options, files[current], contigs, automaton, filter, index.get(), current, window, nullptr, cache, entries[current], writer, report);
+                publish(current);
             });
         }
+    }
+
+    {
+        stats::ScopedTimer timer(report, "write_output");
+        string content;
+        fs::path outputPath(options.output.string().append("/output.txt"));
+        if (presence) {
+            content = presence_matrix(contigs, files, columns);
+            outputPath = options.presence;
+            for (size_t begin = 0, end; emit && begin < content.size(); begin = end + 1) {
+                end = content.find('\n', begin);
+                emit(string_view(content).substr(begin, end - begin + 1));
+            }
+        }
         else {
-            fasta::find_contigs(file.path(), contigs, (100 - options.accept), options.nucl, [&outputFile, &currentOutputResult](const string &nameA, const string &nameB, const string &value, double percentage) -> void {
-                outputFile << nameA << "\t";
-                currentOutputResult << nameB << " -> " << nameA << " -> " << (100.0 - percentage) << "%" << endl << value << endl;
-            });
+            content = "Filename\t\n";
+            for (const auto &row : rows) content += row;
         }
+        ResultWriter::Output outputFile(writer.open(outputPath));
+        writer.write(outputFile, move(content));
+        writer.close(outputFile);
+        writer.drain();
+    }
+    if (writer.failed()) {
+        cout << "Impossible d'écrire les résultats dans : " << options.output << endl;
+        return EXIT_FAILURE;
+    }
 
-        outputFile << "\n";
-        currentOutputResult.close();
-        remove(file);
+    // Les résultats des fichiers recherchés n'entrent dans le cache qu'une fois écrits.
+    size_t cached(0);
+    if (cache.is_open()) {
+        stats::ScopedTimer timer(report, "store_cache");
+        for (size_t i = 0; i < files.size(); i++) {
+            if (entries[i].hit) {
+                cached++;
+                continue;
+            }
+            bool stored;
+            if (presence) {
+                string bits;
+                for (bool bit : columns[i]) bits += bit ? '1' : '0';
+                stored = cache.store(entries[i].key, bits, fs::path());
+            }
+            else stored = cache.store(entries[i].key, string_view(rows[i]).substr(directory::fileNameWithoutExtension(files[i]).size() + 1), result_path(options, files[i]));
+            if (!stored) cout << "Impossible d'ajouter au cache le résultat de : " << files[i] << endl;
+        }
     }
 
-    outputFile.close();
+    if (report != nullptr) {
+        report->set("threads", options.threads);
+        report->set("contigs", contigs.name_count());
+        report->set("file_count", files.size());
+        if (cache.is_open()) report->set("cached_files", cached);
+        if (report->write(options.stats) != EXIT_SUCCESS) {
+            cout << "Impossible d'écrire le rapport : " << options.stats << endl;
+            return EXIT_FAILURE;
+        }
+    }
 
     return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
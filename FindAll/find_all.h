@@ -6,10 +6,52 @@
 #define CONTIG_FIND_ALL_H
 
 
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+
 #include "../Foundation/include/program_option.h"
+#include "../Foundation/include/aho_corasick.h"
+#include "../Foundation/include/contig_set.h"
+#include "../Foundation/include/seed_filter.h"
+#include "../Foundation/include/stats.h"
 
 namespace find_all {
+    /**
+     * Contigs du fichier A et structures de recherche, construits une seule fois pour toutes les recherches.
+     * Les motifs du filtre sont des vues sur les séquences de contigs : un déplacement pourrait les invalider
+     * (petites séquences gardées dans la chaîne elle-même), une requête reste donc là où prepare() l'a construite.
+     */
+    struct Query {
+        Query() = default;
+        Query(const Query&) = delete;
+        Query &operator=(const Query&) = delete;
+
+        fasta::ContigSet contigs;
+        aho_corasick::Automaton automaton;
+        fasta::SeedFilter filter;
+    };
+
+    /** Reçoit une ligne de output.txt (ou de la matrice de présence), retour à la ligne compris. */
+    typedef std::function<void(std::string_view)> LineSink;
+
     int start(const program_option::FindAll &options);
+    /** Charge les contigs du fichier A et construit les structures dont la recherche décrite par options a besoin. */
+    std::unique_ptr<Query> prepare(const program_option::FindAll &options, stats::Report *report);
+    /**
+     * Cherche query dans les fichiers de options.inputB (dossier ou fichier fasta). Si emit n'est pas vide, il reçoit les lignes
+     * de output.txt dans l'ordre, chacune dès que les fichiers qui la précèdent sont traités (la matrice de présence à la fin).
+     */
+    int run(const program_option::FindAll &options, const Query &query, stats::Report *report, const LineSink &emit);
+    /**
+     * Mode serveur (--serve) : le fichier A est préparé une seule fois, puis chaque ligne reçue (entrée standard ou socket Unix)
+     * décrit une recherche avec ses propres INPUTB, OUTPUT, PRESENCE et STATS. Sans OUTPUT, chaque recherche écrit dans un
+     * nouveau sous-dossier job-<n> ; une recherche ne peut pas réutiliser une sortie d'une recherche précédente. La réponse à
+     * une ligne est le contenu de output.txt (ou de la matrice de présence), envoyé ligne à ligne, suivi de OK et du dossier
+     * de sortie, ou d'une ligne ERREUR.
+     */
+    int serve(const program_option::FindAll &options);
 }
 
 #endif //CONTIG_FIND_ALL_H
@@ -0,0 +1,200 @@
+//
+// Created by Florian Claisse on 17/10/2026.
+//
+
+#include <cerrno>
+#include <csignal>
+#include <set>
+#include <sstream>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "../Foundation/include/fasta.h"
+#include "find_all.h"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+/** Ligne qui arrête le serveur. */
+static const string STOP("stop");
+
+/** Chemins de sortie des recherches déjà traitées : une recherche ne peut pas écraser les résultats d'une autre. */
+typedef set<fs::path> Outputs;
+
+/** Premier sous-dossier job-<n> libre de base. */
+static fs::path next_job(const fs::path &base) {
+    for (size_t n = 1;; n++) {
+        fs::path candidate(base / ("job-" + to_string(n)));
+        if (!fs::exists(candidate)) return candidate;
+    }
+}
+
+/**
+ * Options d'une recherche : celles du serveur, remplacées par les options de la ligne (INPUTB obligatoire, OUTPUT,
+ * PRESENCE et STATS). Sans OUTPUT, la recherche écrit dans un nouveau sous-dossier job-<n> du dossier de sortie du
+ * serveur (ou du dossier B). La matrice de présence et le rapport demandés au lancement du serveur sont placés dans le
+ * dossier de sortie de la recherche.
+ * Renvoie un message d'erreur, vide si la ligne est valide.
+ */
+static string parse_job(const string &line, const program_option::FindAll &defaults, Outputs &used, program_option::FindAll &job) {
+    job = defaults;
+    job.inputB.clear();
+    job.output.clear();
+    job.presence.clear();
+    job.stats.clear();
+    istringstream stream(line);
+    string option, value;
+    while (stream >> option) {
+        if (!(stream >> value)) return "option sans valeur : " + option;
+        if (option == INPUTB) job.inputB = value;
+        else if (option == OUTPUT) job.output = value;
+        else if (option == PRESENCE) job.presence = value;
+        else if (option == STATS) job.stats = value;
+        else return "option inconnue : " + option;
+    }
+    if (job.inputB.empty()) return string("l'option ") + INPUTB + " est obligatoire";
+    if (!fs::exists(job.inputB)) return "le dossier ou fichier n'existe pas : " + job.inputB.string();
+    if (!fs::is_directory(job.inputB) && !fasta::is_input_file(job.inputB)) return "ce n'est pas un dossier ou un fichier fasta : " + job.inputB.string();
+
+    bool ownDirectory(job.output.empty());
+    if (ownDirectory) {
+        fs::path base(defaults.output);
+        if (base.empty()) base = fs::is_directory(job.inputB) ? job.inputB : fs::absolute(job.inputB).parent_path();
+        if (!fs::is_directory(base)) return "ce n'est pas un dossier : " + base.string();
+        job.output = next_job(base);
+    }
+    else if (!fs::is_directory(job.output)) return "ce n'est pas un dossier : " + job.output.string();
+    if (job.presence.empty() && !defaults.presence.empty()) job.presence = job.output / defaults.presence.filename();
+    if (job.max_memory != 0 && job.accept != 100 && !job.presence.empty()) return string("la recherche de présence avec différences lit les enregistrements en entier, elle ne respecte pas ") + MAXMEMORY;
+    if (job.stats.empty() && !defaults.stats.empty()) job.stats = job.output / defaults.stats.filename();
+
+    // Une sortie choisie par la ligne ne doit pas avoir servi à une recherche précédente.
+    vector<fs::path> paths;
+    if (!ownDirectory) paths.push_back(fs::weakly_canonical(job.output));
+    for (const fs::path *path : {&job.presence, &job.stats}) {
+        if (!path->empty()) paths.push_back(fs::weakly_canonical(*path));
+    }
+    for (const auto &path : paths) {
+        if (used.count(path) != 0) return "sortie déjà utilisée par une recherche précédente : " + path.string();
+    }
+
+    if (ownDirectory) {
+        error_code error;
+        if (!fs::create_directory(job.output, error)) return "impossible de créer le dossier : " + job.output.string();
+        paths.push_back(fs::weakly_canonical(job.output));
+    }
+    used.insert(paths.begin(), paths.end());
+    return "";
+}
+
+/**
+ * Traite une ligne reçue et envoie sa réponse, ligne à ligne dès qu'elles sont connues.
+ * Renvoie false si la ligne demande l'arrêt du serveur.
+ */
+static bool handle(const string &line, const program_option::FindAll &options, const find_all::Query &query, Outputs &used, const find_all::LineSink &send) {
+    if (line == STOP) return false;
+    if (line.empty()) return true;
+
+    program_option::FindAll job;
+    string error(parse_job(line, options, used, job));
+    if (!error.empty()) {
+        send("ERREUR " + error + "\n");
+        return true;
+    }
+
+    unique_ptr<stats::Report> report;
+    if (!job.stats.empty()) report = make_unique<stats::Report>(FINDALL);
+    int status;
+    try {
+        status = find_all::run(job, query, report.get(), send);
+    }
+    catch (const exception &exception) {
+        // Un fichier illisible ne doit pas arrêter le serveur.
+        send(string("ERREUR ") + exception.what() + "\n");
+        return true;
+    }
+    send(status == EXIT_SUCCESS ? "OK " + job.output.string() + "\n" : "ERREUR recherche sur " + job.inputB.string() + "\n");
+    return true;
+}
+
+/** Lignes de l'entrée standard, réponses sur la sortie standard. */
+static int serve_stdin(const program_option::FindAll &options, const find_all::Query &query) {
+    auto send = [](string_view response) -> void { cout << response << flush; };
+    Outputs used;
+    string line;
+    // Le serveur s'arrête quand la sortie standard est fermée.
+    while (cout && getline(cin, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (!handle(line, options, query, used, send)) break;
+    }
+    return EXIT_SUCCESS;
+}
+
+/** Connexions à une socket Unix traitées l'une après l'autre, chacune pouvant envoyer plusieurs lignes. */
+static int serve_socket(const program_option::FindAll &options, const find_all::Query &query) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    string path(options.serve.string());
+    if (path.size() >= sizeof(address.sun_path)) {
+        cout << "Le chemin de la socket est trop long : " << path << endl;
+        return EXIT_FAILURE;
+    }
+    path.copy(address.sun_path, path.size());
+
+    int server(socket(AF_UNIX, SOCK_STREAM, 0));
+    unlink(path.c_str());
+    if (server < 0 || bind(server, (sockaddr*) &address, sizeof(address)) != 0 || listen(server, 16) != 0) {
+        cout << "Impossible d'ouvrir la socket : " << path << endl;
+        if (server >= 0) close(server);
+        return EXIT_FAILURE;
+    }
+
+    Outputs used;
+    bool running(true);
+    while (running) {
+        int client(accept(server, nullptr, nullptr));
+        if (client < 0) continue;
+        // Un client parti avant sa réponse (EPIPE) est fermé sans arrêter le serveur : la recherche en cours se termine sans rien envoyer.
+        bool connected(true);
+        auto send = [client, &connected](string_view response) -> void {
+            for (size_t sent = 0; connected && sent < response.size();) {
+                ssize_t count(::send(client, response.data() + sent, response.size() - sent, MSG_NOSIGNAL));
+                if (count < 0 && errno == EINTR) continue;
+                if (count <= 0) connected = false;
+                else sent += (size_t) count;
+            }
+        };
+
+        string pending;
+        char buffer[4096];
+        ssize_t count;
+        while (running && connected && (count = read(client, buffer, sizeof(buffer))) > 0) {
+            pending.append(buffer, (size_t) count);
+            size_t end;
+            while (running && connected && (end = pending.find('\n')) != string::npos) {
+                string line(pending, 0, end);
+                pending.erase(0, end + 1);
+                if (!line.empty() && line.back() == '\r') line.pop_back();
+                running = handle(line, options, query, used, send);
+            }
+        }
+        close(client);
+    }
+    close(server);
+    unlink(path.c_str());
+    return EXIT_SUCCESS;
+}
+
+int find_all::serve(const program_option::FindAll &options) {
+    if (!fasta::is_input_file(options.inputA)) {
+        cout << "Le fichier : " << options.inputA << " n'est pas un fichier fasta." << endl;
+        return EXIT_FAILURE;
+    }
+
+    // Une réponse écrite vers un client ou un tube déjà fermé ne doit pas tuer le serveur.
+    signal(SIGPIPE, SIG_IGN);
+    unique_ptr<Query> query(prepare(options, nullptr));
+    if (options.serve == STDIN) return serve_stdin(options, *query);
+    return serve_socket(options, *query);
+}
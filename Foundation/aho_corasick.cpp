@@ -0,0 +1,85 @@
+//
+// Created by Florian Claisse on 17/10/2026.
+//
+
+#include <queue>
+
+#include "include/aho_corasick.h"
+
+using namespace std;
+
+aho_corasick::Automaton::Automaton(): classes{}, sigma(1) {}
+
+size_t aho_corasick::Automaton::add(string_view pattern) {
+    patterns.emplace_back(pattern);
+    lengths.push_back(pattern.size());
+    return lengths.size() - 1;
+}
+
+void aho_corasick::Automaton::build() {
+    // L'alphabet est réduit aux seuls octets présents dans les motifs, la classe 0 regroupe tout le reste.
+    classes.fill(0);
+    sigma = 1;
+    for (const auto &pattern : patterns) {
+        for (const char c : pattern) {
+            if (classes[(unsigned char) c] == 0) classes[(unsigned char) c] = (uint8_t) sigma++;
+        }
+    }
+
+    delta.assign(sigma, -1);
+    first_pattern.assign(1, -1);
+    next_pattern.assign(patterns.size(), -1);
+
+    // Construction du trie.
+    for (size_t id = 0; id < patterns.size(); id++) {
+        if (patterns[id].empty()) continue;
+        int32_t state(0);
+        for (const char c : patterns[id]) {
+            size_t index((size_t) state * sigma + classes[(unsigned char) c]);
+            if (delta[index] < 0) {
+                delta[index] = (int32_t) first_pattern.size();
+                first_pattern.push_back(-1);
+                delta.resize(delta.size() + sigma, -1);
+            }
+            state = delta[index];
+        }
+        // Les doublons sont chaînés dans l'ordre d'ajout.
+        int32_t *tail(&first_pattern[state]);
+        while (*tail >= 0) tail = &next_pattern[*tail];
+        *tail = (int32_t) id;
+    }
+
+    size_t states(first_pattern.size());
+    fail.assign(states, 0);
+    output.assign(states, -1);
+    output_link.assign(states, -1);
+
+    // Parcours en largeur : liens d'échec et complétion des transitions manquantes.
+    queue<int32_t> pending;
+    for (size_t c = 0; c < sigma; c++) {
+        int32_t &next(delta[c]);
+        if (next < 0) next = 0;
+        else pending.push(next);
+    }
+    while (!pending.empty()) {
+        int32_t state(pending.front());
+        pending.pop();
+
+        int32_t suffix(fail[state]);
+        output_link[state] = output[suffix];
+        output[state] = (first_pattern[state] >= 0) ? state : output[suffix];
+
+        for (size_t c = 0; c < sigma; c++) {
+            int32_t &next(delta[(size_t) state * sigma + c]);
+            int32_t fallback(delta[(size_t) suffix * sigma + c]);
+            if (next < 0) next = fallback;
+            else {
+                fail[next] = fallback;
+                pending.push(next);
+            }
+        }
+    }
+
+    patterns.clear();
+    patterns.shrink_to_fit();
+}
@@ -0,0 +1,58 @@
+//
+// Created by Florian Claisse on 17/10/2026.
+//
+
+#include "include/codon.h"
+
+using namespace std;
+
+static constexpr array<uint8_t, 256> make_base_codes() {
+    array<uint8_t, 256> codes{};
+    for (auto &code : codes) code = 4;
+    codes['A'] = 0; codes['C'] = 1; codes['G'] = 2; codes['T'] = 3; codes['U'] = 3;
+    codes['a'] = 0; codes['c'] = 1; codes['g'] = 2; codes['t'] = 3; codes['u'] = 3;
+    return codes;
+}
+
+const array<uint8_t, 256> codon::BASE_CODES(make_base_codes());
+
+// Codons dans l'ordre de leur indice : AAA, AAC, AAG, AAT, ACA ... TTT, puis INVALID.
+const array<char, codon::COUNT + 1> codon::AMINO_ACIDS{
+    'K', 'N', 'K', 'N', 'T', 'T', 'T', 'T', 'R', 'S', 'R', 'S', 'I', 'I', 'M', 'I',
+    'Q', 'H', 'Q', 'H', 'P', 'P', 'P', 'P', 'R', 'R', 'R', 'R', 'L', 'L', 'L', 'L',
+    'E', 'D', 'E', 'D', 'A', 'A', 'A', 'A', 'G', 'G', 'G', 'G', 'V', 'V', 'V', 'V',
+    '*', 'Y', '*', 'Y', 'S', 'S', 'S', 'S', '*', 'C', 'W', 'C', 'L', 'F', 'L', 'F',
+    'X'
+};
+
+string codon::name(size_t index) {
+    static const char bases[] = "ACGT";
+    return {bases[(index >> 4) & 3], bases[(index >> 2) & 3], bases[index & 3]};
+}
+
+void codon::count(string_view sequence, size_t frame, Counts &counts) {
+    const char *data(sequence.data());
+    for (size_t i = frame; i + 3 <= sequence.size(); i += 3) counts[encode(data + i)]++;
+}
+
+void codon::translate(string_view sequence, size_t frame, string &protein) {
+    protein.clear();
+    if (sequence.size() < frame + 3) return;
+    protein.resize((sequence.size() - frame) / 3);
+    const char *data(sequence.data() + frame);
+    for (size_t i = 0; i < protein.size(); i++) protein[i] = AMINO_ACIDS[encode(data + 3 * i)];
+}
+
+void codon::translate_reverse(string_view sequence, size_t frame, string &protein) {
+    protein.clear();
+    if (sequence.size() < frame + 3) return;
+    protein.resize((sequence.size() - frame) / 3);
+    const char *data(sequence.data() + sequence.size() - frame);
+    for (size_t i = 0; i < protein.size(); i++) {
+        // Le codon du complément inverse est formé des bases data[-1], data[-2], data[-3] complémentées.
+        const char *end(data - 3 * i);
+        char triplet[3] = {end[-1], end[-2], end[-3]};
+        size_t index(encode(triplet));
+        protein[i] = AMINO_ACIDS[index == INVALID ? INVALID : COUNT - 1 - index];
+    }
+}
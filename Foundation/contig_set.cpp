@@ -0,0 +1,84 @@
+//
+// Created by Florian Claisse on 17/10/2026.
+//
+
+#include <algorithm>
+#include <numeric>
+
+#include "include/contig_set.h"
+#include "include/fasta_reader.h"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+fasta::ContigSet::ContigSet(const fs::path &filePath) {
+    Reader reader(filePath);
+    Record record;
+    // En-têtes et séquences tiennent dans la taille du fichier : une seule allocation pour tout le contenu.
+    reserve(reader.size());
+    while (reader.next(record)) add(record.header, record.sequence);
+    build();
+}
+
+fasta::ContigSet::ContigSet(const map<string, string> &contigs) {
+    size_t bytes(0);
+    for (const auto &contig : contigs) bytes += contig.first.size() + contig.second.size();
+    reserve(bytes);
+    for (const auto &contig : contigs) add(contig.first, contig.second);
+    build();
+}
+
+void fasta::ContigSet::add(string_view name, string_view sequence) {
+    if (sequence.empty()) return;
+    name_offsets.push_back(arena.size());
+    name_lengths.push_back(name.size());
+    arena.append(name);
+    name_sequences.push_back(offsets.size());
+    offsets.push_back(arena.size());
+    lengths.push_back(sequence.size());
+    arena.append(sequence);
+}
+
+void fasta::ContigSet::build() {
+    auto name_of = [this](size_t index) -> string_view { return name(index); };
+    auto sequence_of = [this](size_t index) -> string_view { return sequence(name_sequences[index]); };
+
+    // Un nom répété ne garde que son dernier ajout.
+    vector<size_t> order(name_offsets.size());
+    iota(order.begin(), order.end(), 0);
+    stable_sort(order.begin(), order.end(), [&name_of](size_t a, size_t b) -> bool { return name_of(a) < name_of(b); });
+    vector<size_t> kept;
+    kept.reserve(order.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        if (i + 1 < order.size() && name_of(order[i]) == name_of(order[i + 1])) continue;
+        kept.push_back(order[i]);
+    }
+
+    // Séquences par longueur puis contenu, les noms d'une même séquence restent dans l'ordre alphabétique.
+    stable_sort(kept.begin(), kept.end(), [&sequence_of](size_t a, size_t b) -> bool {
+        string_view first(sequence_of(a)), second(sequence_of(b));
+        if (first.size() != second.size()) return first.size() < second.size();
+        return first < second;
+    });
+
+    vector<size_t> new_offsets, new_lengths, new_name_offsets, new_name_lengths;
+    first_names.clear();
+    for (size_t i = 0; i < kept.size(); i++) {
+        size_t current(kept[i]);
+        if (i == 0 || sequence_of(kept[i - 1]) != sequence_of(current)) {
+            first_names.push_back(new_name_offsets.size());
+            new_offsets.push_back(offsets[name_sequences[current]]);
+            new_lengths.push_back(lengths[name_sequences[current]]);
+        }
+        new_name_offsets.push_back(name_offsets[current]);
+        new_name_lengths.push_back(name_lengths[current]);
+    }
+    first_names.push_back(new_name_offsets.size());
+
+    offsets = move(new_offsets);
+    lengths = move(new_lengths);
+    name_offsets = move(new_name_offsets);
+    name_lengths = move(new_name_lengths);
+    name_sequences.clear();
+    name_sequences.shrink_to_fit();
+}
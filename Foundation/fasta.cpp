@@ -5,11 +5,13 @@
 #include <fstream>
 #include <tuple>
 #include <functional>
+#include <array>
 #ifdef __linux__
 #include <algorithm>
 #endif
 
 #include "include/fasta.h"
+#include "include/fasta_search.h"
 #include "include/directory.h"
 
 using namespace std;
@@ -49,9 +51,7 @@ map<string, string> fasta::decode_fastaline(const fs::path &filePath) {
 
     string contig;
     string sequence;
-    while(!inputFile.eof()) {
-        getline(inputFile, contig);
-        getline(inputFile, sequence);
+    while(getline(inputFile, contig) && getline(inputFile, sequence)) {
         result[contig] = sequence;
     }
     inputFile.close();
@@ -70,93 +70,280 @@ bool fasta::is_fastaline_file(const fs::path &filePath) {
     return is_regular_file(filePath) && directory::have_extension(filePath, "fastaline");
 }
 
-bool fasta::find_contig(const fs::path &filePath, const string &contig) {
-    ifstream test_file;
-    test_file.open(filePath);
+bool fasta::is_sequence_file(const fs::path &filePath) {
+    return is_regular_file(filePath) && directory::have_extension(filePath, SEQUENCE_FILE_EXTENSION);
+}
 
-    string lineRead;
-    while(getline(test_file, lineRead)) {
-        if (lineRead.at(0) == '>') continue;
-        if (lineRead.find(contig) != string::npos) return true;
+bool fasta::is_input_file(const fs::path &filePath) {
+    return is_fasta_file(filePath) || is_sequence_file(filePath);
+}
+
+vector<fs::path> fasta::input_files(const fs::path &directory) {
+    map<string, fs::path> containers;
+    for (const auto &currentFile : fs::directory_iterator(directory)) {
+        if (is_sequence_file(currentFile)) containers.emplace(directory::fileNameWithoutExtension(currentFile.path()), currentFile.path());
+    }
+
+    vector<fs::path> files;
+    for (const auto &currentFile : fs::directory_iterator(directory)) {
+        if (!is_fasta_file(currentFile)) continue;
+        auto container(containers.find(directory::fileNameWithoutExtension(currentFile.path())));
+        if (container == containers.end()) files.push_back(currentFile.path());
+        // Un conteneur plus ancien que son fichier fasta n'est plus à jour.
+        else if (fs::last_write_time(container->second) < fs::last_write_time(currentFile)) {
+            files.push_back(currentFile.path());
+            containers.erase(container);
+        }
+    }
+    for (const auto &container : containers) files.push_back(container.second);
+    sort(files.begin(), files.end());
+    return files;
+}
+
+int fasta::to_sequence_file(const fs::path &filePath, const fs::path &output, bool packed) {
+    // Le fichier lu reste projeté pendant l'écriture : il ne peut pas être remplacé.
+    if (fs::exists(output) && fs::equivalent(filePath, output)) return EXIT_FAILURE;
+    return SequenceFile::write(filePath, output, packed);
+}
+
+fasta::ContigSet fasta::load_contigs(const fs::path &filePath) {
+    return ContigSet(filePath);
+}
+
+fasta::ContigSet fasta::load_contigs(const fs::path &filePath, const vector<string> &names) {
+    ContigSet contigs;
+    SequenceFile file(filePath);
+    if (file.is_valid()) {
+        string buffer;
+        for (const auto &name : names) {
+            size_t index(file.find(name));
+            if (index < file.size() && file.verify(index)) contigs.add(file.name(index), file.sequence(index, buffer));
+        }
+    }
+    else {
+        vector<string> sorted(names);
+        sort(sorted.begin(), sorted.end());
+        Reader reader(filePath);
+        Record record;
+        while (reader.next(record)) {
+            if (binary_search(sorted.begin(), sorted.end(), record.header)) contigs.add(record.header, record.sequence);
+        }
+    }
+    contigs.build();
+    return contigs;
+}
+
+bool fasta::find_contig(const fs::path &filePath, const string &contig) {
+    Reader reader(filePath);
+    Record record;
+    while (reader.next(record)) {
+        if (record.sequence.find(contig) != string_view::npos) return true;
     }
     return false;
 }
 
-void fasta::find_contig(const fs::path &file_path, const map<string, string> &contigs, bool nucleic, function<void(const string&, const string&, const string&)> func) {
-    ifstream test_file;
-    test_file.open(file_path);
-
-    string line_read, name;
-    while(getline(test_file, line_read)) {
-        if (line_read.at(0) == '>') name = line_read;
-        else {
-            size_t pos = 0;
-            for(const auto &contig : contigs) {
-                while((pos = line_read.find(contig.second, pos)) != string::npos) {
-                    if (nucleic) func(contig.first, name, contig.second);
-                    else func(contig.first, name, line_read);
-                    pos++;
-                }
-                pos = 0;
+string fasta::reverse_complement(string_view sequence) {
+    static const array<char, 256> complement([]() {
+        array<char, 256> table{};
+        for (size_t c = 0; c < table.size(); c++) table[c] = (char) c;
+        const string from("ACGTRYKMBVDHacgtrykmbvdh"), to("TGCAYRMKVBHDtgcayrmkvbhd");
+        for (size_t i = 0; i < from.size(); i++) table[(unsigned char) from[i]] = to[i];
+        return table;
+    }());
+
+    string result(sequence.rbegin(), sequence.rend());
+    for (auto &c : result) c = complement[(unsigned char) c];
+    return result;
+}
+
+vector<string> fasta::detail::reverse_contigs(const ContigSet &contigs) {
+    vector<string> result;
+    result.reserve(contigs.size());
+    for (size_t contig = 0; contig < contigs.size(); contig++) {
+        result.push_back(fasta::reverse_complement(contigs.sequence(contig)));
+        if (result.back() == contigs.sequence(contig)) result.back().clear();
+    }
+    return result;
+}
+
+vector<fasta::detail::Chunk> fasta::detail::split(size_t size, size_t boundary, size_t overlap, size_t workers) {
+    size_t chunk(max({MIN_CHUNK, boundary / (4 * max<size_t>(workers, 1)) + 1, overlap + 1}));
+    vector<Chunk> chunks;
+    for (size_t begin = 0; begin < boundary; begin += chunk) {
+        size_t owned(min(chunk, boundary - begin));
+        chunks.push_back({begin, min(size, begin + owned + overlap), owned});
+    }
+    return chunks;
+}
+
+string fasta::detail::read_sequence(const fs::path &file_path, size_t offset) {
+    Reader reader(file_path);
+    Record record;
+    reader.seek(offset);
+    return reader.next(record) ? string(record.sequence) : string();
+}
+
+aho_corasick::Automaton fasta::build_automaton(const ContigSet &contigs, bool both_strands) {
+    aho_corasick::Automaton automaton;
+    for (size_t contig = 0; contig < contigs.size(); contig++) automaton.add(contigs.sequence(contig));
+    if (both_strands) {
+        for (const auto &reverse : detail::reverse_contigs(contigs)) automaton.add(reverse);
+    }
+    automaton.build();
+    return automaton;
+}
+
+void fasta::find_contig(const fs::path &file_path, const ContigSet &contigs, bool nucleic, function<void(const string&, const string&, const string&)> func) {
+    find_contig(file_path, contigs, build_automaton(contigs), nucleic, func);
+}
+
+void fasta::find_contig(const fs::path &file_path, const ContigSet &contigs, const aho_corasick::Automaton &automaton, bool nucleic, function<void(const string&, const string&, const string&)> func) {
+    find_contig(file_path, contigs, automaton, nucleic, false, [&func](const string &nameA, const string &nameB, const string &value, char) -> void {
+        func(nameA, nameB, value);
+    });
+}
+
+void fasta::find_contig(const fs::path &file_path, const ContigSet &contigs, const aho_corasick::Automaton &automaton, bool nucleic, bool both_strands, function<void(const string&, const string&, const string&, char)> func, ThreadPool *pool) {
+    auto sink = [&func](string_view nameA, string_view nameB, string_view value, char strand) -> void {
+        func(string(nameA), string(nameB), string(value), strand);
+    };
+    if (nucleic) find_exact<true>(file_path, contigs, automaton, both_strands, sink, 0, pool);
+    else find_exact<false>(file_path, contigs, automaton, both_strands, sink, 0, pool);
+}
+
+void fasta::find_contigs(const fs::path &file_path, const ContigSet &contigs, int maxErrorPercentage, bool nucleic, function<void(const string&, const string&, const string&, double)> func) {
+    find_contigs(file_path, contigs, maxErrorPercentage, nucleic, false, [&func](const string &nameA, const string &nameB, const string &value, double percentage, char) -> void {
+        func(nameA, nameB, value, percentage);
+    });
+}
+
+void fasta::find_contigs(const fs::path &file_path, const ContigSet &contigs, int maxErrorPercentage, bool nucleic, bool both_strands, function<void(const string&, const string&, const string&, double, char)> func, ThreadPool *pool) {
+    SeedFilter filter(contigs, maxErrorPercentage, nucleic && both_strands);
+    auto sink = [&func](string_view nameA, string_view nameB, string_view value, double percentage, char strand) -> void {
+        func(string(nameA), string(nameB), string(value), percentage, strand);
+    };
+    if (nucleic) find_seeded<true>(file_path, contigs, filter, sink, 0, pool);
+    else find_seeded<false>(file_path, contigs, filter, sink, 0, pool);
+}
+
+void fasta::find_packed_contigs(const fs::path &file_path, const ContigSet &contigs, int maxErrorPercentage, bool both_strands, function<void(const string&, const string&, const string&, double, char)> func) {
+    find_approximate<true>(file_path, contigs, maxErrorPercentage, both_strands, [&func](string_view nameA, string_view nameB, string_view value, double percentage, char strand) -> void {
+        func(string(nameA), string(nameB), string(value), percentage, strand);
+    });
+}
+
+void fasta::find_presence(const fs::path &file_path, const ContigSet &contigs, const aho_corasick::Automaton &automaton, vector<bool> &found, size_t window) {
+    found.assign(contigs.size(), false);
+    size_t remaining(contigs.size());
+    size_t overlap(contigs.empty() ? 0 : contigs.length(contigs.size() - 1) - 1);
+
+    Reader reader(file_path);
+    Record record;
+    stats::Counters &counters(stats::local());
+    while (remaining != 0 && (window == 0 ? reader.next(record) : reader.next_window(record, window, overlap))) {
+        if (record.start == 0) counters.records++;
+        counters.positions += record.sequence.size() - (record.start == 0 ? 0 : overlap);
+        automaton.search_while(record.sequence, [&](size_t id, size_t) -> bool {
+            size_t contig(id < contigs.size() ? id : id - contigs.size());
+            if (!found[contig]) {
+                found[contig] = true;
+                remaining--;
             }
-        }
+            return remaining != 0;
+        });
     }
 }
 
-/*map<string, double> equalSearch(const string &text, const string &pattern, double maxErrorPercentage) {
-    unsigned long text_size(text.size());
-    unsigned long pattern_size(pattern.size());
-    unsigned long maxError((unsigned long) (pattern_size * maxErrorPercentage / 100.0));
-    unsigned long error(0);
+void fasta::find_presence(const fs::path &file_path, const ContigSet &contigs, int maxErrorPercentage, bool nucleic, bool both_strands, vector<bool> &found) {
+    found.assign(contigs.size(), false);
+    size_t remaining(contigs.size());
 
-    for (unsigned long i = 0; i < text_size; i++) {
-        for (unsigned long j = 0; j < pattern_size; j++) {
-            if (i + j > text_size) {
-                error += (pattern_size - j);
-                break;
+    Reader reader(file_path);
+    Record record;
+    stats::Counters &counters(stats::local());
+    if (!nucleic) {
+        while (remaining != 0 && reader.next(record)) {
+            counters.records++;
+
+            const char *text(record.sequence.data());
+            size_t text_size(record.sequence.size());
+            for (size_t contig = 0; contig < contigs.size(); contig++) {
+                if (found[contig]) continue;
+                const char *pattern(contigs.sequence(contig).data());
+                size_t pattern_size(contigs.length(contig));
+                size_t maxError(pattern_size * (size_t) maxErrorPercentage / 100);
+                for (size_t i = 0; i < text_size; i++) {
+                    size_t overlap(min(pattern_size, text_size - i));
+                    size_t error(pattern_size - overlap);
+                    if (error > maxError) break;
+                    counters.positions++;
+                    if (error + hamming::count(text + i, pattern, overlap, maxError - error) > maxError) continue;
+                    found[contig] = true;
+                    remaining--;
+                    break;
+                }
             }
-            if (text[i + j] != pattern[j]) error++;
-            if (error >= result) break;
         }
-        result = min(result, error);
-        error = 0;
-    }
-
-    return (((double)result) / ((double)pattern_size)) * 100.0;
-}*/
-
-void fasta::find_contigs(const fs::path &file_path, const map<string, string> &contigs, int maxErrorPercentage, bool nucleic, function<void(const string&, const string&, const string&, double)> func) {
-    ifstream  test_file;
-    test_file.open(file_path);
-
-    string line_read, name;
-    while(getline(test_file, line_read)) {
-        if (line_read.at(0) == '>') name = line_read;
-        else {
-            unsigned long text_size(line_read.size());
-            for (const auto &contig : contigs) {
-                // equalSearch 
-                unsigned long pattern_size(contig.second.size());
-                unsigned long maxError((unsigned long) (pattern_size * maxErrorPercentage / 100));
-                unsigned long error(0);
-                for (unsigned long i = 0; i < text_size; i++) {
-                    for (unsigned long j = 0; j < pattern_size; j++) {
-                        if (i + j > text_size) {
-                            error += (pattern_size - j);
-                            break;
-                        }
-                        if (line_read[i + j] != contig.second[j]) error++;
-                        if (error > maxError) break;
-                    }
-                    if (error <= maxError) {
-                        if (nucleic) func(contig.first, name, contig.second, (((double)error) / ((double)pattern_size)) * 100.0);
-                        else func(contig.first, name, line_read, (((double)error) / ((double)pattern_size)) * 100.0);
-                    }
-                    error = 0;
-                }   
+        return;
+    }
+
+    vector<string> reverse;
+    if (both_strands) reverse = detail::reverse_contigs(contigs);
+    vector<packed::Sequence> patterns;
+    patterns.reserve(contigs.size() * 2);
+    for (size_t contig = 0; contig < contigs.size(); contig++) {
+        patterns.emplace_back(contigs.sequence(contig));
+        if (both_strands) patterns.emplace_back(reverse[contig]);
+    }
+
+    packed::Sequence text;
+    size_t strands(both_strands ? 2 : 1);
+    while (remaining != 0 && reader.next(record, text)) {
+        counters.records++;
+        for (size_t contig = 0; contig < contigs.size(); contig++) {
+            for (size_t strand = 0; !found[contig] && strand < strands; strand++) {
+                const packed::Sequence &pattern(patterns[contig * strands + strand]);
+                if (pattern.empty()) continue;
+                size_t maxError(pattern.size() * (size_t) maxErrorPercentage / 100);
+                size_t first(packed::find(text, pattern, maxError));
+                counters.positions += first < text.size() ? first + 1 : detail::offsets_tried(text.size(), pattern.size(), maxError);
+                if (first == text.size()) continue;
+                found[contig] = true;
+                remaining--;
             }
         }
     }
 }
 
+void fasta::find_edit_presence(const fs::path &file_path, const ContigSet &contigs, int maxErrorPercentage, bool both_strands, vector<bool> &found) {
+    found.assign(contigs.size(), false);
+    size_t remaining(contigs.size());
+
+    vector<string> reverse;
+    if (both_strands) reverse = detail::reverse_contigs(contigs);
+    vector<myers::Pattern> patterns;
+    patterns.reserve(contigs.size() * 2);
+    for (size_t contig = 0; contig < contigs.size(); contig++) {
+        patterns.emplace_back(contigs.sequence(contig));
+        if (both_strands) patterns.emplace_back(reverse[contig]);
+    }
 
+    Reader reader(file_path);
+    Record record;
+    stats::Counters &counters(stats::local());
+    size_t strands(both_strands ? 2 : 1);
+    while (remaining != 0 && reader.next(record)) {
+        counters.records++;
+        for (size_t contig = 0; contig < contigs.size(); contig++) {
+            for (size_t strand = 0; !found[contig] && strand < strands; strand++) {
+                if (strand == 1 && reverse[contig].empty()) continue;
+                const myers::Pattern &pattern(patterns[contig * strands + strand]);
+                size_t end(myers::find(record.sequence, pattern, pattern.size() * (size_t) maxErrorPercentage / 100));
+                counters.positions += end != 0 ? end : record.sequence.size();
+                if (end == 0) continue;
+                found[contig] = true;
+                remaining--;
+            }
+        }
+    }
+}
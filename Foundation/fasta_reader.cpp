@@ -0,0 +1,189 @@
+//
+// Created by Florian Claisse on 17/10/2026.
+//
+
+#include <algorithm>
+#include <cstring>
+
+#include "include/fasta_reader.h"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+fasta::Reader::Reader(const fs::path &filePath): file(filePath, true), data(file.data()), length(file.size()), position(0) {
+    if (!SequenceFile::has_magic(data, length)) return;
+    // Un conteneur invalide est lu comme un fichier vide plutôt que comme du texte.
+    container = make_unique<SequenceFile>(data, length);
+    position = container->size() == 0 ? length : container->entry_offset(0);
+}
+
+string_view fasta::Reader::read_line() {
+    const char *begin(data + position);
+    const char *end((const char*) memchr(begin, '\n', length - position));
+    if (end == nullptr) end = data + length;
+    position = (size_t) (end - data) + (end < data + length ? 1 : 0);
+
+    size_t size((size_t) (end - begin));
+    if (size > 0 && begin[size - 1] == '\r') size--;
+    return {begin, size};
+}
+
+bool fasta::Reader::corrupted() {
+    position = length;
+    in_record = false;
+    return false;
+}
+
+static bool is_upper_sequence(string_view line) {
+    for (const char c : line) {
+        if (c >= 'a' && c <= 'z') return false;
+    }
+    return true;
+}
+
+bool fasta::Reader::next(Record &record) {
+    if (container) {
+        size_t index(current_entry());
+        if (index >= container->size()) return false;
+        if (!container->verify(index)) return corrupted();
+        record.offset = position;
+        record.header = container->name(index);
+        record.sequence = container->sequence(index, buffer);
+        record.start = 0;
+        record.last = true;
+        in_record = false;
+        position += sizeof(SequenceEntry);
+        return true;
+    }
+
+    // Les lignes précédant le premier en-tête sont ignorées.
+    while (position < length && data[position] != '>') read_line();
+    if (position >= length) return false;
+
+    record.offset = position;
+    record.header = read_line();
+    record.start = 0;
+    record.last = true;
+    in_record = false;
+
+    // Cas courant d'une séquence sur une seule ligne déjà en majuscules : aucune copie.
+    size_t first_line(position);
+    string_view line(position < length && data[position] != '>' ? read_line() : string_view());
+    if ((position >= length || data[position] == '>') && is_upper_sequence(line)) {
+        record.sequence = line;
+        return true;
+    }
+
+    position = first_line;
+    buffer.clear();
+    while (position < length && data[position] != '>') {
+        line = read_line();
+        size_t start(buffer.size());
+        buffer.append(line);
+        for (size_t i = start; i < buffer.size(); i++) {
+            if (buffer[i] >= 'a' && buffer[i] <= 'z') buffer[i] = (char) (buffer[i] - 'a' + 'A');
+        }
+    }
+    record.sequence = buffer;
+    return true;
+}
+
+bool fasta::Reader::next(Record &record, packed::Sequence &sequence) {
+    if (container) {
+        if (!next(record)) return false;
+        sequence.clear();
+        sequence.append(record.sequence);
+        record.sequence = string_view();
+        return true;
+    }
+
+    while (position < length && data[position] != '>') read_line();
+    if (position >= length) return false;
+
+    record.offset = position;
+    record.header = read_line();
+    record.sequence = string_view();
+    record.start = 0;
+    record.last = true;
+    in_record = false;
+
+    sequence.clear();
+    while (position < length && data[position] != '>') sequence.append(read_line());
+    return true;
+}
+
+bool fasta::Reader::next_window(Record &record, size_t size, size_t overlap) {
+    if (size <= overlap) size = overlap + 1;
+    if (container) {
+        size_t index(current_entry());
+        if (index >= container->size()) return false;
+        if (in_record) {
+            window_begin = window_end - min(overlap, window_end - window_begin);
+            record.start = window_begin;
+        }
+        else {
+            if (!container->verify(index)) return corrupted();
+            window_begin = 0;
+            record.offset = position;
+            record.header = container->name(index);
+            record.start = 0;
+            in_record = true;
+        }
+
+        // Une séquence sur 8 bits est lue directement dans le fichier, sans copie.
+        record.sequence = container->sequence(index, window_begin, size, buffer);
+        window_end = window_begin + record.sequence.size();
+        record.last = window_end >= container->length(index);
+        if (record.last) {
+            position += sizeof(SequenceEntry);
+            in_record = false;
+        }
+        return true;
+    }
+
+    if (in_record) {
+        // La fin de la fenêtre précédente est reprise au début de la nouvelle.
+        size_t kept(min(overlap, buffer.size()));
+        record.start += buffer.size() - kept;
+        buffer.erase(0, buffer.size() - kept);
+    }
+    else {
+        while (position < length && data[position] != '>') read_line();
+        if (position >= length) return false;
+
+        record.offset = position;
+        record.header = read_line();
+        record.start = 0;
+        buffer.clear();
+        in_record = true;
+    }
+
+    // Copie de la séquence jusqu'à size octets, les lignes pouvant être coupées au milieu.
+    while (buffer.size() < size && position < length) {
+        bool line_start(position == 0 || data[position - 1] == '\n');
+        if (line_start && data[position] == '>') break;
+
+        const char *begin(data + position);
+        const char *end((const char*) memchr(begin, '\n', length - position));
+        if (end == nullptr) end = data + length;
+        size_t take(min((size_t) (end - begin), size - buffer.size()));
+        for (size_t i = 0; i < take; i++) {
+            char c(begin[i]);
+            if (c == '\r') continue;
+            buffer.push_back((c >= 'a' && c <= 'z') ? (char) (c - 'a' + 'A') : c);
+        }
+        position += take;
+        if (position < length && data[position] == '\n') position++;
+    }
+
+    // L'enregistrement est terminé si seuls des sauts de ligne précèdent l'en-tête suivant ou la fin du fichier.
+    size_t next(position);
+    while (next < length && (data[next] == '\n' || data[next] == '\r')) next++;
+    record.last = next >= length || (data[next] == '>' && (next == 0 || data[next - 1] == '\n'));
+    if (record.last) {
+        position = next;
+        in_record = false;
+    }
+    record.sequence = buffer;
+    return true;
+}
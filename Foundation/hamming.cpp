@@ -0,0 +1,98 @@
+//
+// Created by Florian Claisse on 17/10/2026.
+//
+
+#include "include/hamming.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define HAMMING_X86
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+size_t hamming::count_scalar(const char *a, const char *b, size_t size, size_t budget) {
+    size_t error(0);
+    for (size_t i = 0; i < size; i++) {
+        error += (a[i] != b[i]);
+        if (error > budget) break;
+    }
+    return error;
+}
+
+#ifdef HAMMING_X86
+
+// Chaque noyau compare un bloc complet puis vérifie le budget, la fin est traitée en scalaire.
+// popcnt fait partie de leur cible : sans elle, __builtin_popcount devient un appel de bibliothèque dans la boucle.
+
+__attribute__((target("sse2,popcnt")))
+static size_t count_sse2(const char *a, const char *b, size_t size, size_t budget) {
+    size_t error(0), i(0);
+    for (; i + 16 <= size; i += 16) {
+        __m128i va(_mm_loadu_si128((const __m128i*) (a + i)));
+        __m128i vb(_mm_loadu_si128((const __m128i*) (b + i)));
+        unsigned equal((unsigned) _mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)));
+        error += 16 - (size_t) __builtin_popcount(equal);
+        if (error > budget) return error;
+    }
+    return error + hamming::count_scalar(a + i, b + i, size - i, budget - error);
+}
+
+__attribute__((target("avx2,popcnt")))
+static size_t count_avx2(const char *a, const char *b, size_t size, size_t budget) {
+    size_t error(0), i(0);
+    for (; i + 32 <= size; i += 32) {
+        __m256i va(_mm256_loadu_si256((const __m256i*) (a + i)));
+        __m256i vb(_mm256_loadu_si256((const __m256i*) (b + i)));
+        unsigned equal((unsigned) _mm256_movemask_epi8(_mm256_cmpeq_epi8(va, vb)));
+        error += 32 - (size_t) __builtin_popcount(equal);
+        if (error > budget) return error;
+    }
+    return error + count_sse2(a + i, b + i, size - i, budget - error);
+}
+
+__attribute__((target("avx512f,avx512bw,popcnt")))
+static size_t count_avx512(const char *a, const char *b, size_t size, size_t budget) {
+    size_t error(0), i(0);
+    for (; i + 64 <= size; i += 64) {
+        __m512i va(_mm512_loadu_si512((const void*) (a + i)));
+        __m512i vb(_mm512_loadu_si512((const void*) (b + i)));
+        error += (size_t) __builtin_popcountll(_mm512_cmpneq_epi8_mask(va, vb));
+        if (error > budget) return error;
+    }
+    return error + count_avx2(a + i, b + i, size - i, budget - error);
+}
+
+#endif
+
+typedef size_t (*Kernel)(const char*, const char*, size_t, size_t);
+
+struct Dispatch {
+    Kernel kernel;
+    const char *name;
+};
+
+static Dispatch select_kernel() {
+#ifdef HAMMING_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("popcnt")) {
+        if (__builtin_cpu_supports("avx512bw")) return {count_avx512, "avx512"};
+        if (__builtin_cpu_supports("avx2")) return {count_avx2, "avx2"};
+        if (__builtin_cpu_supports("sse2")) return {count_sse2, "sse2"};
+    }
+#endif
+    return {hamming::count_scalar, "scalar"};
+}
+
+static const Dispatch &dispatch() {
+    static const Dispatch selected(select_kernel());
+    return selected;
+}
+
+size_t hamming::count(const char *a, const char *b, size_t size, size_t budget) {
+    return dispatch().kernel(a, b, size, budget);
+}
+
+const char *hamming::isa() {
+    return dispatch().name;
+}
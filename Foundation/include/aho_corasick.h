@@ -0,0 +1,82 @@
+//
+// Created by Florian Claisse on 17/10/2026.
+//
+
+#ifndef CONTIGDIFF_AHO_CORASICK_H
+#define CONTIGDIFF_AHO_CORASICK_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace aho_corasick {
+    /**
+     * Automate de recherche multi-motifs (Aho-Corasick).
+     * Les motifs sont ajoutés avec add() puis l'automate est figé par build(). Une recherche
+     * parcourt le texte une seule fois et signale chaque occurrence de chaque motif, quel que
+     * soit le nombre de motifs.
+     */
+    class Automaton {
+    public:
+        Automaton();
+
+        /** Ajoute un motif à l'automate et renvoie son identifiant (ordre d'ajout). Un motif vide n'est jamais signalé. */
+        std::size_t add(std::string_view pattern);
+        /** Calcule les liens d'échec et la table de transitions complète. Doit être appelé avant search(). */
+        void build();
+
+        /** Nombre de motifs ajoutés. */
+        std::size_t size() const { return lengths.size(); }
+        /** Longueur du motif d'identifiant id. */
+        std::size_t length(std::size_t id) const { return lengths[id]; }
+
+        /**
+         * Parcourt le texte et appelle on_match(id, position) pour chaque occurrence, position étant
+         * l'indice de début du motif dans le texte. Les occurrences sont signalées par position de fin
+         * croissante, puis du motif le plus long au plus court.
+         */
+        template<typename F>
+        void search(std::string_view text, F &&on_match) const {
+            std::int32_t state(0);
+            for (std::size_t i = 0; i < text.size(); i++) {
+                state = delta[(std::size_t) state * sigma + classes[(unsigned char) text[i]]];
+                for (std::int32_t out = output[state]; out >= 0; out = output_link[out]) {
+                    for (std::int32_t id = first_pattern[out]; id >= 0; id = next_pattern[id]) {
+                        on_match((std::size_t) id, i + 1 - lengths[id]);
+                    }
+                }
+            }
+        }
+
+        /** Identique à search(), mais le parcours s'arrête dès que on_match renvoie false. Renvoie false si le parcours a été interrompu. */
+        template<typename F>
+        bool search_while(std::string_view text, F &&on_match) const {
+            std::int32_t state(0);
+            for (std::size_t i = 0; i < text.size(); i++) {
+                state = delta[(std::size_t) state * sigma + classes[(unsigned char) text[i]]];
+                for (std::int32_t out = output[state]; out >= 0; out = output_link[out]) {
+                    for (std::int32_t id = first_pattern[out]; id >= 0; id = next_pattern[id]) {
+                        if (!on_match((std::size_t) id, i + 1 - lengths[id])) return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+    private:
+        std::array<std::uint8_t, 256> classes; // octet -> classe de l'alphabet (0 = absent des motifs)
+        std::size_t sigma;                      // nombre de classes
+        std::vector<std::int32_t> delta;        // transitions : état * sigma + classe
+        std::vector<std::int32_t> fail;
+        std::vector<std::int32_t> output;       // état de sortie le plus proche (lui-même ou via les liens d'échec), -1 sinon
+        std::vector<std::int32_t> output_link;  // état de sortie suivant dans la chaîne des suffixes
+        std::vector<std::int32_t> first_pattern;// premier motif se terminant exactement dans l'état
+        std::vector<std::int32_t> next_pattern; // motif suivant (doublons) se terminant dans le même état
+        std::vector<std::size_t> lengths;
+        std::vector<std::string> patterns;      // conservés jusqu'à build()
+    };
+}
+
+#endif //CONTIGDIFF_AHO_CORASICK_H
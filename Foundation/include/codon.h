@@ -0,0 +1,50 @@
+//
+// Created by Florian Claisse on 17/10/2026.
+//
+
+#ifndef CONTIGDIFF_CODON_H
+#define CONTIGDIFF_CODON_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace codon {
+    /** Nombre de codons A/C/G/T, indicés par leur code 2 bits (A=0, C=1, G=2, T=3, première base en poids fort). */
+    constexpr std::size_t COUNT = 64;
+    /** Indice réservé aux triplets contenant une base ambiguë. */
+    constexpr std::size_t INVALID = COUNT;
+
+    /** Comptage par codon, la dernière case reçoit les triplets invalides. */
+    typedef std::array<std::uint64_t, COUNT + 1> Counts;
+
+    /** Code 2 bits de chaque octet, 4 pour tout ce qui n'est pas A/C/G/T (ou U), minuscules comprises. */
+    extern const std::array<std::uint8_t, 256> BASE_CODES;
+
+    /** Indice du codon commençant en triplet, INVALID s'il contient une base ambiguë. Sans branchement. */
+    inline std::size_t encode(const char *triplet) {
+        std::uint8_t a(BASE_CODES[(unsigned char) triplet[0]]), b(BASE_CODES[(unsigned char) triplet[1]]), c(BASE_CODES[(unsigned char) triplet[2]]);
+        std::size_t index(((std::size_t) a << 4) | ((std::size_t) b << 2) | (std::size_t) c);
+        return ((a | b | c) & 4) ? INVALID : index;
+    }
+
+    /** Texte du codon d'indice index ("AAA" ... "TTT"). */
+    std::string name(std::size_t index);
+
+    /** Ajoute à counts les codons complets de sequence lus à partir de frame (0, 1 ou 2). */
+    void count(std::string_view sequence, std::size_t frame, Counts &counts);
+
+    /** Acide aminé (code standard, '*' pour les codons stop) de chaque indice de codon, 'X' pour INVALID. */
+    extern const std::array<char, COUNT + 1> AMINO_ACIDS;
+
+    /** Remplace protein par la traduction des codons complets de sequence lus à partir de frame (0, 1 ou 2). */
+    void translate(std::string_view sequence, std::size_t frame, std::string &protein);
+    /**
+     * Identique à translate sur le complément inverse de sequence, sans le construire : les codons sont lus de la fin vers
+     * le début et le complément d'un codon A/C/G/T d'indice i a l'indice COUNT - 1 - i.
+     */
+    void translate_reverse(std::string_view sequence, std::size_t frame, std::string &protein);
+}
+
+#endif //CONTIGDIFF_CODON_H
@@ -0,0 +1,61 @@
+//
+// Created by Florian Claisse on 17/10/2026.
+//
+
+#ifndef CONTIGDIFF_CONTIG_SET_H
+#define CONTIGDIFF_CONTIG_SET_H
+
+#include <filesystem>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fasta {
+    /**
+     * Ensemble des contigs cherchés. Les en-têtes et les séquences sont rangés bout à bout dans une seule
+     * zone mémoire, les tables (position, longueur) sont des tableaux séparés. Les séquences identiques ne
+     * sont gardées qu'une fois et sont triées par longueur croissante, chaque séquence ayant la liste de ses
+     * noms triés. Comme avec une map, un en-tête répété ne garde que sa dernière séquence ; les
+     * enregistrements sans séquence sont ignorés.
+     * Les contigs sont ajoutés avec add() puis l'ensemble est figé par build().
+     */
+    class ContigSet {
+    public:
+        ContigSet() = default;
+        /** Charge tous les enregistrements d'un fichier fasta (en-tête avec le '>'). */
+        explicit ContigSet(const std::filesystem::path &filePath);
+        /** Construit l'ensemble à partir de paires en-tête -> séquence. */
+        explicit ContigSet(const std::map<std::string, std::string> &contigs);
+
+        /** Réserve la place de bytes octets d'en-têtes et de séquences. */
+        void reserve(std::size_t bytes) { arena.reserve(bytes); }
+        void add(std::string_view name, std::string_view sequence);
+        /** Déduplique et trie les séquences. Doit être appelé avant toute lecture. */
+        void build();
+
+        /** Nombre de séquences distinctes, identifiées de 0 à size() - 1. */
+        std::size_t size() const { return offsets.size(); }
+        bool empty() const { return offsets.empty(); }
+        std::string_view sequence(std::size_t id) const { return {arena.data() + offsets[id], lengths[id]}; }
+        std::size_t length(std::size_t id) const { return lengths[id]; }
+
+        /** Noms [names_begin(id), names_end(id)) de la séquence id. */
+        std::size_t names_begin(std::size_t id) const { return first_names[id]; }
+        std::size_t names_end(std::size_t id) const { return first_names[id + 1]; }
+        std::string_view name(std::size_t index) const { return {arena.data() + name_offsets[index], name_lengths[index]}; }
+        /** Nombre de contigs (noms) de l'ensemble. */
+        std::size_t name_count() const { return name_offsets.size(); }
+
+    private:
+        std::string arena;
+        std::vector<std::size_t> offsets;
+        std::vector<std::size_t> lengths;
+        std::vector<std::size_t> first_names;   // size() + 1 entrées
+        std::vector<std::size_t> name_offsets;
+        std::vector<std::size_t> name_lengths;
+        std::vector<std::size_t> name_sequences;// avant build() : séquence de chaque nom, dans l'ordre d'ajout
+    };
+}
+
+#endif //CONTIGDIFF_CONTIG_SET_H
@@ -10,24 +10,86 @@
 #include <map>
 #include <vector>
 #include <functional>
+#include <string_view>
+
+#include "aho_corasick.h"
+#include "contig_set.h"
+#include "sequence_file.h"
+
+class ThreadPool;
 
 namespace fasta {
-    /** Transforme un fichier fasta vers un nouveau fichier en format fastaline. */
+    /** Transforme un fichier fasta vers un nouveau fichier en format fastaline. Remplacé par to_sequence_file. */
     int to_fasta_line(const std::filesystem::path &filePath);
 
     std::map<std::string, std::string> decode_fastaline(const std::filesystem::path &filePath);
+    /**
+     * Transforme un fichier fasta vers un conteneur binaire output (voir SequenceFile), lu ensuite sans analyse de texte
+     * par toutes les recherches. Avec packed, les séquences nucléiques sans base ambiguë sont codées sur 2 bits.
+     */
+    int to_sequence_file(const std::filesystem::path &filePath, const std::filesystem::path &output, bool packed = false);
+    /** Charge les contigs directement depuis un fichier fasta ou un conteneur binaire, sans passer par le format fastaline. */
+    ContigSet load_contigs(const std::filesystem::path &filePath);
+    /**
+     * Charge seulement les contigs d'en-têtes names ('>' compris). Dans un conteneur binaire, chacun est retrouvé par
+     * sa table triée sans lire les autres séquences, un enregistrement dont la somme de contrôle est fausse n'étant pas
+     * chargé ; un fichier fasta est parcouru en entier.
+     */
+    ContigSet load_contigs(const std::filesystem::path &filePath, const std::vector<std::string> &names);
 
-    /** Permet de savoir si un fichier est de type fasta. */
+    /** Permet de savoir si un fichier est de type fasta (texte, sans les conteneurs binaires). */
     bool is_fasta_file(const std::filesystem::path &filePath);
     /** Permet de savoir si un fichier est de type fastaline. */
     bool is_fastaline_file(const std::filesystem::path &filePath);
+    /** Permet de savoir si un fichier est un conteneur binaire de séquences. */
+    bool is_sequence_file(const std::filesystem::path &filePath);
+    /** Permet de savoir si un fichier peut être lu par les recherches : fichier fasta ou conteneur binaire. */
+    bool is_input_file(const std::filesystem::path &filePath);
+    /**
+     * Fichiers fasta et conteneurs binaires d'un dossier, triés par nom. Un fichier fasta et un conteneur de même nom
+     * (foo.fasta et foo.fastabin) ne sont lus qu'une fois : le conteneur s'il n'est pas plus ancien, le fichier fasta sinon.
+     */
+    std::vector<std::filesystem::path> input_files(const std::filesystem::path &directory);
 
-    /** Dans un fichier de type fastaline permet de dire si un contig est présent. */
+    /** Dans un fichier de type fasta permet de dire si un contig est présent. */
     bool find_contig(const std::filesystem::path &filePath, const std::string &contig);
-    /** Dans un fichier de type fastaline permet de dire si tous les contigs sont présent ou non. */
-    void find_contig(const std::filesystem::path &file_path, const std::map<std::string, std::string> &contigs, bool nucleic, std::function<void(const std::string&, const std::string&, const std::string&)> func);
-    /** Dans un fichier de type fastaline permet de dire si tous les sont présent ou non avec un certains pourcentage d'erreur. */
-    void find_contigs(const std::filesystem::path &file_path, const std::map<std::string, std::string> &contigs, int maxErrorPercentage, bool nucleic, std::function<void(const std::string&, const std::string&, const std::string&, double)> func);
+    /** Complément inverse d'une séquence nucléique (codes IUPAC compris, les autres symboles sont conservés). */
+    std::string reverse_complement(std::string_view sequence);
+
+    /**
+     * Construit l'automate multi-motifs des séquences des contigs, les identifiants sont ceux de l'ensemble.
+     * Avec both_strands, les compléments inverses sont ajoutés à la suite (identifiants décalés de contigs.size()).
+     */
+    aho_corasick::Automaton build_automaton(const ContigSet &contigs, bool both_strands = false);
+    /** Dans un fichier de type fasta permet de dire si tous les contigs sont présent ou non. */
+    void find_contig(const std::filesystem::path &file_path, const ContigSet &contigs, bool nucleic, std::function<void(const std::string&, const std::string&, const std::string&)> func);
+    /** Identique à find_contig mais avec un automate déjà construit par build_automaton à partir des mêmes contigs. */
+    void find_contig(const std::filesystem::path &file_path, const ContigSet &contigs, const aho_corasick::Automaton &automaton, bool nucleic, std::function<void(const std::string&, const std::string&, const std::string&)> func);
+    /**
+     * Identique à find_contig, le brin ('+' ou '-') de chaque résultat est transmis. L'automate doit avoir été construit avec le même both_strands.
+     * Avec pool, les grandes séquences sont découpées en morceaux cherchés en parallèle (voir find_exact dans fasta_search.h).
+     */
+    void find_contig(const std::filesystem::path &file_path, const ContigSet &contigs, const aho_corasick::Automaton &automaton, bool nucleic, bool both_strands, std::function<void(const std::string&, const std::string&, const std::string&, char)> func, ThreadPool *pool = nullptr);
+    /** Dans un fichier de type fasta permet de dire si tous les sont présent ou non avec un certains pourcentage d'erreur. */
+    void find_contigs(const std::filesystem::path &file_path, const ContigSet &contigs, int maxErrorPercentage, bool nucleic, std::function<void(const std::string&, const std::string&, const std::string&, double)> func);
+    /**
+     * Identique à find_contigs, avec both_strands (nucl uniquement) le complément inverse de chaque contig est aussi cherché et le brin est transmis.
+     * Les positions comparées sont filtrées par graines (SeedFilter), le résultat est celui d'une comparaison à toutes les positions.
+     * Avec pool, les grandes séquences sont découpées en morceaux cherchés en parallèle.
+     */
+    void find_contigs(const std::filesystem::path &file_path, const ContigSet &contigs, int maxErrorPercentage, bool nucleic, bool both_strands, std::function<void(const std::string&, const std::string&, const std::string&, double, char)> func, ThreadPool *pool = nullptr);
+    /** Version nucléique de find_contigs sans filtre : cibles et contigs sont codés sur 2 bits et comparés à toutes les positions. */
+    void find_packed_contigs(const std::filesystem::path &file_path, const ContigSet &contigs, int maxErrorPercentage, bool both_strands, std::function<void(const std::string&, const std::string&, const std::string&, double, char)> func);
+    /**
+     * Mode présence : found[id] indique si la séquence id de l'ensemble est présente au moins une fois dans le fichier, sur l'un
+     * des brins si l'automate a été construit avec both_strands. Le parcours du fichier s'arrête dès que toutes sont trouvées.
+     * Avec window non nul, les enregistrements sont lus par fenêtres de window octets (voir Reader::next_window).
+     */
+    void find_presence(const std::filesystem::path &file_path, const ContigSet &contigs, const aho_corasick::Automaton &automaton, std::vector<bool> &found, std::size_t window = 0);
+    /** Identique à find_presence avec au plus maxErrorPercentage % de différences : une séquence n'est plus cherchée dès qu'elle est trouvée. */
+    void find_presence(const std::filesystem::path &file_path, const ContigSet &contigs, int maxErrorPercentage, bool nucleic, bool both_strands, std::vector<bool> &found);
+    /** Identique à find_presence avec au plus maxErrorPercentage % d'éditions (substitutions, insertions, délétions). */
+    void find_edit_presence(const std::filesystem::path &file_path, const ContigSet &contigs, int maxErrorPercentage, bool both_strands, std::vector<bool> &found);
 }
 
 #endif //CONTIGDIFF_FASTADECODER_H
@@ -0,0 +1,79 @@
+//
+// Created by Florian Claisse on 17/10/2026.
+//
+
+#ifndef CONTIGDIFF_FASTA_READER_H
+#define CONTIGDIFF_FASTA_READER_H
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "mapped_file.h"
+#include "packed_sequence.h"
+#include "sequence_file.h"
+
+namespace fasta {
+    /** Enregistrement d'un fichier fasta. Les vues restent valides jusqu'au prochain appel à Reader::next. */
+    struct Record {
+        std::string_view header;   // ligne d'en-tête, '>' compris
+        std::string_view sequence; // séquence en majuscules, lignes jointes
+        std::size_t offset;        // position de l'en-tête dans le fichier (de l'entrée de l'enregistrement pour un conteneur binaire)
+        std::size_t start = 0;     // position de sequence dans la séquence complète (lecture par fenêtres)
+        bool last = true;          // sequence termine l'enregistrement
+    };
+
+    /**
+     * Lecteur de fichier fasta projeté en mémoire (mmap).
+     * Les enregistrements sont lus un à un sans fichier intermédiaire : une séquence tenant sur une
+     * seule ligne déjà en majuscules est renvoyée directement depuis le fichier, sinon ses lignes
+     * sont jointes et mises en majuscules dans un tampon réutilisé.
+     * Un conteneur binaire (voir SequenceFile) est reconnu à sa signature et lu par sa table des enregistrements, sans
+     * analyse de texte : toutes les recherches acceptent indifféremment les deux formats. La lecture d'un conteneur
+     * s'arrête au premier enregistrement dont la somme de contrôle est fausse.
+     */
+    class Reader {
+    public:
+        explicit Reader(const std::filesystem::path &filePath);
+
+        Reader(const Reader&) = delete;
+        Reader &operator=(const Reader&) = delete;
+
+        /** Indique si le fichier a pu être ouvert et projeté. */
+        bool is_open() const { return file.is_open(); }
+        /** Lit l'enregistrement suivant, renvoie false à la fin du fichier. */
+        bool next(Record &record);
+        /** Lit l'enregistrement suivant en codant sa séquence sur 2 bits directement depuis le fichier, record.sequence reste vide. */
+        bool next(Record &record, packed::Sequence &sequence);
+        /**
+         * Lecture par fenêtres d'au plus size octets de séquence (size > overlap) : renvoie la suite de l'enregistrement en cours
+         * en reprenant les overlap derniers octets de la fenêtre précédente, ou le début de l'enregistrement suivant. La mémoire
+         * utilisée ne dépend plus de la taille des enregistrements. record.start et record.last situent la fenêtre.
+         */
+        bool next_window(Record &record, std::size_t size, std::size_t overlap);
+        /** Repositionne la lecture sur un octet du fichier (début d'un en-tête, ou Record::offset d'un conteneur binaire). */
+        void seek(std::size_t offset) { position = offset < length ? offset : length; }
+        /** Taille du fichier en octets. */
+        std::size_t size() const { return length; }
+
+    private:
+        /** Renvoie la ligne courante (sans '\n' ni '\r') et avance à la suivante. */
+        std::string_view read_line();
+        /** Arrête la lecture d'un conteneur binaire sur un enregistrement corrompu, renvoie false. */
+        bool corrupted();
+        /** Enregistrement du conteneur binaire à la position courante, container->size() à la fin. */
+        std::size_t current_entry() const { return container->index_at(position); }
+
+        MappedFile file;
+        const char *data;
+        std::size_t length;
+        std::size_t position;
+        std::string buffer;
+        bool in_record = false;    // un enregistrement est en cours de lecture par fenêtres
+        std::unique_ptr<SequenceFile> container; // nul pour un fichier fasta texte
+        std::size_t window_begin = 0, window_end = 0; // fenêtre précédente dans un conteneur binaire
+    };
+}
+
+#endif //CONTIGDIFF_FASTA_READER_H
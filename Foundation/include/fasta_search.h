@@ -0,0 +1,693 @@
+//
+// Created by Florian Claisse on 17/10/2026.
+//
+
+#ifndef CONTIGDIFF_FASTA_SEARCH_H
+#define CONTIGDIFF_FASTA_SEARCH_H
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "aho_corasick.h"
+#include "codon.h"
+#include "contig_set.h"
+#include "fasta_reader.h"
+#include "hamming.h"
+#include "myers.h"
+#include "packed_sequence.h"
+#include "seed_filter.h"
+#include "stats.h"
+#include "thread_pool.h"
+
+/**
+ * Moteurs de recherche de fasta.h sous forme de templates : le mode (nucl/prot) est un paramètre du
+ * template et le sink est appelé directement, sans std::function. Chaque combinaison est compilée en
+ * une boucle dédiée. Les fonctions de fasta.h sont de simples enveloppes autour de celles-ci.
+ */
+namespace fasta {
+    namespace detail {
+        /** Compléments inverses des séquences de l'ensemble, vides pour les séquences palindromiques (déjà trouvées sur le brin direct). */
+        std::vector<std::string> reverse_contigs(const ContigSet &contigs);
+
+        /** Séquence complète de l'enregistrement dont l'en-tête est à offset dans le fichier. */
+        std::string read_sequence(const std::filesystem::path &file_path, std::size_t offset);
+
+        /** Nombre de positions essayées pour un contig dans une séquence : celles où le dépassement de la fin reste dans le budget. */
+        inline std::uint64_t offsets_tried(std::size_t text_size, std::size_t pattern_size, std::size_t maxError) {
+            long long last((long long) text_size - (long long) pattern_size + (long long) maxError);
+            return (std::uint64_t) std::max(0LL, std::min((long long) text_size, last + 1));
+        }
+
+        /** En dessous de cette taille, les positions d'une séquence ne sont pas réparties entre les workers. */
+        const std::size_t MIN_CHUNK = 1 << 22;
+
+        /** Morceau [begin, end) d'une séquence, qui ne garde que les occurrences commençant avant begin + boundary. */
+        struct Chunk {
+            std::size_t begin;
+            std::size_t end;
+            std::size_t boundary;
+        };
+
+        /**
+         * Découpe les boundary premières positions d'une séquence de size octets en morceaux consécutifs, chacun
+         * prolongé de overlap octets (dans la limite de size) pour contenir les occurrences qui débordent sur le
+         * suivant. Chaque position de départ appartient à un seul morceau : aucune occurrence n'est trouvée deux fois.
+         * Le nombre de morceaux vaut quelques fois workers pour que le vol de tâches équilibre la charge.
+         */
+        std::vector<Chunk> split(std::size_t size, std::size_t boundary, std::size_t overlap, std::size_t workers);
+
+        /** Bases décodées à la fois pour chercher les graines d'une séquence codée sur 2 bits. */
+        const std::size_t SEED_BLOCK = 1 << 16;
+
+        /**
+         * find_seeded en nucl pour des enregistrements lus en entier : chaque séquence est codée sur 2 bits dès la lecture
+         * (Reader::next) et les positions candidates sont vérifiées sur les mots de 32 bases (packed::mismatches). Seules les
+         * graines sont cherchées dans le texte, décodé par blocs de SEED_BLOCK bases : la mémoire d'un enregistrement est
+         * le quart de sa taille. Même résultat et même ordre que la vérification octet par octet.
+         */
+        template<typename Sink>
+        void find_seeded_packed(const std::filesystem::path &file_path, const ContigSet &contigs, const SeedFilter &filter, Sink &sink, ThreadPool *pool) {
+            struct Found {
+                std::size_t pattern;
+                std::size_t start;
+                std::size_t error;
+            };
+            const auto &patterns(filter.patterns());
+            std::vector<packed::Sequence> packed_patterns;
+            packed_patterns.reserve(patterns.size());
+            std::size_t longest(0);
+            for (const auto &pattern : patterns) {
+                packed_patterns.emplace_back(pattern.sequence);
+                longest = std::max(longest, pattern.sequence.size());
+            }
+            std::size_t seed_overlap(filter.longest_seed() == 0 ? 0 : filter.longest_seed() - 1);
+
+            Reader reader(file_path);
+            Record record;
+            packed::Sequence text;
+            stats::Counters &counters(stats::local());
+            auto emit = [&](std::size_t id, std::size_t error) -> void {
+                const SeedFilter::Pattern &pattern(patterns[id]);
+                double percentage((((double)error) / ((double)pattern.sequence.size())) * 100.0);
+                for (std::size_t n = contigs.names_begin(pattern.contig); n < contigs.names_end(pattern.contig); n++) sink(contigs.name(n), record.header, pattern.sequence, percentage, pattern.strand);
+            };
+
+            // Vérifie les positions [from, to) de text. Avec found nul, les occurrences sont signalées au fur et à mesure.
+            auto collect = [&](std::size_t from, std::size_t to, std::vector<Found> *found, std::vector<SeedFilter::Candidate> &seeds, std::string &block, std::vector<packed::Hit> &hits, stats::Counters &tally) -> void {
+                // Les graines d'une occurrence qui commence avant to se terminent avant to + longest.
+                seeds.clear();
+                std::size_t end(std::min(text.size(), to + longest));
+                for (std::size_t begin = from; begin < end; begin += SEED_BLOCK) {
+                    text.unpack(begin, std::min(SEED_BLOCK + seed_overlap, end - begin), block);
+                    filter.add_candidates(block, begin, SEED_BLOCK, seeds);
+                }
+                SeedFilter::sort_candidates(seeds);
+
+                auto candidate(seeds.cbegin());
+                for (std::size_t id = 0; id < patterns.size(); id++) {
+                    const SeedFilter::Pattern &pattern(patterns[id]);
+                    const packed::Sequence &sequence(packed_patterns[id]);
+                    std::size_t pattern_size(sequence.size()), maxError(pattern.max_error);
+                    auto verify = [&](std::size_t start) -> void {
+                        // La partie du contig qui dépasse la fin de la séquence compte comme autant d'erreurs.
+                        std::size_t inside(std::min(pattern_size, text.size() - start));
+                        std::size_t error(pattern_size - inside);
+                        if (error > maxError) return;
+                        tally.positions++;
+                        error += packed::mismatches(text, start, sequence, inside, maxError - error);
+                        if (error > maxError) return;
+                        if (found == nullptr) emit(id, error);
+                        else found->push_back({id, start, error});
+                    };
+
+                    if (pattern.seeded) {
+                        for (; candidate != seeds.cend() && candidate->pattern == id; ++candidate) {
+                            if (candidate->start >= from && candidate->start < to) verify(candidate->start);
+                        }
+                    }
+                    else {
+                        // Sans graine, toutes les positions sont comparées par la boucle de packed::scan.
+                        std::size_t limit(text.size() + maxError >= pattern_size ? text.size() + maxError - pattern_size + 1 : 0);
+                        if (limit > from) tally.positions += std::min(to, limit) - from;
+                        hits.clear();
+                        packed::scan(text, sequence, maxError, from, to, hits);
+                        for (const auto &hit : hits) {
+                            if (found == nullptr) emit(id, hit.error);
+                            else found->push_back({id, hit.offset, hit.error});
+                        }
+                    }
+                }
+            };
+
+            std::vector<SeedFilter::Candidate> candidates;
+            std::string block;
+            std::vector<packed::Hit> hits;
+            std::vector<Found> pending;
+            std::vector<std::vector<Found>> parts;
+            std::vector<std::vector<SeedFilter::Candidate>> part_candidates;
+            std::vector<std::string> part_blocks;
+            std::vector<std::vector<packed::Hit>> part_hits;
+            std::vector<stats::Counters> part_counters;
+            while (reader.next(record, text)) {
+                counters.records++;
+                if (pool == nullptr || text.size() < 2 * MIN_CHUNK) {
+                    collect(0, text.size(), nullptr, candidates, block, hits, counters);
+                    continue;
+                }
+
+                // Les morceaux se partagent la séquence codée, chacun décode ses propres blocs.
+                std::vector<Chunk> chunks(split(text.size(), text.size(), 0, pool->size()));
+                parts.assign(chunks.size(), std::vector<Found>());
+                part_candidates.resize(chunks.size());
+                part_blocks.resize(chunks.size());
+                part_hits.resize(chunks.size());
+                part_counters.assign(chunks.size(), stats::Counters());
+                for (std::size_t i = 0; i < chunks.size(); i++) {
+                    pool->submit([&, i]() -> void {
+                        collect(chunks[i].begin, chunks[i].begin + chunks[i].boundary, &parts[i], part_candidates[i], part_blocks[i], part_hits[i], part_counters[i]);
+                    });
+                }
+                pool->wait();
+                for (std::size_t i = 0; i < chunks.size(); i++) {
+                    pending.insert(pending.end(), parts[i].begin(), parts[i].end());
+                    counters += part_counters[i];
+                }
+                std::stable_sort(pending.begin(), pending.end(), [](const Found &a, const Found &b) -> bool {
+                    if (a.pattern != b.pattern) return a.pattern < b.pattern;
+                    return a.start < b.start;
+                });
+                for (const auto &current : pending) emit(current.pattern, current.error);
+                pending.clear();
+            }
+        }
+    }
+
+    /**
+     * Recherche exacte par l'automate (construit par build_automaton avec le même both_strands).
+     * sink(nameA, nameB, value, strand) est appelé pour chaque occurrence et chaque nom de la séquence trouvée,
+     * value étant la séquence de l'enregistrement en prot et le contig (ou son complément inverse) en nucl.
+     * Les vues transmises ne restent valides que pendant l'appel.
+     * Avec window non nul, les enregistrements sont lus par fenêtres de window octets (voir Reader::next_window) :
+     * les occurrences d'un enregistrement lu en plusieurs fenêtres sont gardées jusqu'à sa fin puis signalées
+     * dans le même ordre qu'une lecture complète.
+     * Avec pool, les séquences d'au moins 2 * MIN_CHUNK octets sont découpées en morceaux cherchés par ses workers,
+     * leurs occurrences sont réunies puis signalées dans ce même ordre, depuis le thread appelant. L'appelant ne doit
+     * pas être un worker de pool.
+     */
+    template<bool nucleic, typename Sink>
+    void find_exact(const std::filesystem::path &file_path, const ContigSet &contigs, const aho_corasick::Automaton &automaton, bool both_strands, Sink &&sink, std::size_t window = 0, ThreadPool *pool = nullptr) {
+        // L'automate identifie les séquences par leur identifiant dans l'ensemble, suivies de leurs compléments inverses.
+        std::vector<std::string> reverse;
+        if (nucleic && both_strands) reverse = detail::reverse_contigs(contigs);
+
+        // Occurrence en attente : fin et longueur donnent l'ordre de l'automate.
+        struct Pending {
+            std::size_t end;
+            std::size_t length;
+            std::size_t id;
+        };
+        std::vector<Pending> pending;
+        std::size_t overlap(contigs.empty() ? 0 : contigs.length(contigs.size() - 1) - 1);
+
+        Reader reader(file_path);
+        Record record;
+        std::string sequence;
+        stats::Counters &counters(stats::local());
+        auto emit = [&](std::size_t id, std::string_view text) -> void {
+            bool forward(id < contigs.size());
+            std::size_t contig(forward ? id : id - contigs.size());
+            std::string_view value;
+            if constexpr (!nucleic) value = text;
+            else value = forward ? contigs.sequence(contig) : std::string_view(reverse[contig]);
+            for (std::size_t n = contigs.names_begin(contig); n < contigs.names_end(contig); n++) sink(contigs.name(n), record.header, value, forward ? '+' : '-');
+        };
+
+        // Occurrences de text commençant avant boundary, base étant la position de text dans l'enregistrement.
+        auto collect = [&automaton](std::string_view text, std::size_t boundary, std::size_t base, std::vector<Pending> &found) -> void {
+            automaton.search(text, [&](std::size_t id, std::size_t start) -> void {
+                if (start < boundary) found.push_back({base + start + automaton.length(id), automaton.length(id), id});
+            });
+        };
+
+        std::vector<std::vector<Pending>> parts;
+        while (window == 0 ? reader.next(record) : reader.next_window(record, window, overlap)) {
+            if (record.start == 0) counters.records++;
+            counters.positions += record.sequence.size() - (record.start == 0 ? 0 : overlap);
+
+            // Une occurrence qui commence dans le recouvrement est laissée à la fenêtre suivante.
+            std::size_t boundary(record.last ? record.sequence.size() : record.sequence.size() - overlap);
+            bool chunked(pool != nullptr && boundary >= 2 * detail::MIN_CHUNK);
+            if (record.start == 0 && record.last && !chunked) {
+                automaton.search(record.sequence, [&](std::size_t id, std::size_t) -> void { emit(id, record.sequence); });
+                continue;
+            }
+
+            if (chunked) {
+                std::vector<detail::Chunk> chunks(detail::split(record.sequence.size(), boundary, overlap, pool->size()));
+                parts.assign(chunks.size(), std::vector<Pending>());
+                for (std::size_t i = 0; i < chunks.size(); i++) {
+                    pool->submit([&, i]() -> void {
+                        const detail::Chunk &chunk(chunks[i]);
+                        collect(record.sequence.substr(chunk.begin, chunk.end - chunk.begin), chunk.boundary, record.start + chunk.begin, parts[i]);
+                    });
+                }
+                pool->wait();
+                for (const auto &part : parts) pending.insert(pending.end(), part.begin(), part.end());
+            }
+            else collect(record.sequence, boundary, record.start, pending);
+            if (!record.last || pending.empty()) continue;
+
+            std::stable_sort(pending.begin(), pending.end(), [](const Pending &a, const Pending &b) -> bool {
+                if (a.end != b.end) return a.end < b.end;
+                return a.length > b.length;
+            });
+            // En prot, une séquence lue en plusieurs fenêtres est relue en entier pour être écrite.
+            std::string_view text(record.sequence);
+            if constexpr (!nucleic) {
+                if (record.start != 0) {
+                    sequence = detail::read_sequence(file_path, record.offset);
+                    text = sequence;
+                }
+            }
+            for (const auto &current : pending) emit(current.id, text);
+            pending.clear();
+        }
+    }
+
+    /**
+     * Recherche avec au plus maxErrorPercentage % de différences (distance de Hamming).
+     * sink(nameA, nameB, value, percentage, strand) est appelé par séquence de l'ensemble (brin direct en premier),
+     * puis par position, puis pour chacun de ses noms. En nucl, cibles et contigs sont codés sur 2 bits et comparés
+     * sans être décodés, both_strands n'est utilisé qu'en nucl. Les vues transmises ne restent valides que pendant l'appel.
+     */
+    template<bool nucleic, typename Sink>
+    void find_approximate(const std::filesystem::path &file_path, const ContigSet &contigs, int maxErrorPercentage, bool both_strands, Sink &&sink) {
+        Reader reader(file_path);
+        Record record;
+        stats::Counters &counters(stats::local());
+
+        if constexpr (!nucleic) {
+            while (reader.next(record)) {
+                counters.records++;
+
+                const char *text(record.sequence.data());
+                unsigned long text_size(record.sequence.size());
+                for (std::size_t contig = 0; contig < contigs.size(); contig++) {
+                    const char *pattern(contigs.sequence(contig).data());
+                    unsigned long pattern_size(contigs.length(contig));
+                    unsigned long maxError((unsigned long) (pattern_size * maxErrorPercentage / 100));
+                    counters.positions += detail::offsets_tried(text_size, pattern_size, maxError);
+                    for (unsigned long i = 0; i < text_size; i++) {
+                        // La partie du contig qui dépasse la fin de la séquence compte comme autant d'erreurs.
+                        unsigned long overlap(std::min(pattern_size, text_size - i));
+                        unsigned long error(pattern_size - overlap);
+                        if (error > maxError) break;
+                        error += hamming::count(text + i, pattern, overlap, maxError - error);
+                        if (error > maxError) continue;
+                        double percentage((((double)error) / ((double)pattern_size)) * 100.0);
+                        for (std::size_t n = contigs.names_begin(contig); n < contigs.names_end(contig); n++) sink(contigs.name(n), record.header, record.sequence, percentage, '+');
+                    }
+                }
+            }
+        }
+        else {
+            // Pour chaque séquence, le brin direct puis éventuellement le complément inverse.
+            std::vector<std::string> reverse;
+            if (both_strands) reverse = detail::reverse_contigs(contigs);
+            std::vector<packed::Sequence> patterns;
+            patterns.reserve(contigs.size() * 2);
+            for (std::size_t contig = 0; contig < contigs.size(); contig++) {
+                patterns.emplace_back(contigs.sequence(contig));
+                if (both_strands) patterns.emplace_back(reverse[contig]);
+            }
+
+            packed::Sequence text;
+            std::vector<packed::Hit> hits;
+            while (reader.next(record, text)) {
+                counters.records++;
+
+                auto pattern(patterns.begin());
+                for (std::size_t contig = 0; contig < contigs.size(); contig++) {
+                    for (char strand : {'+', '-'}) {
+                        if (strand == '-' && !both_strands) break;
+                        std::string_view value(strand == '+' ? contigs.sequence(contig) : std::string_view(reverse[contig]));
+                        unsigned long pattern_size(pattern->size());
+                        unsigned long maxError((unsigned long) (pattern_size * maxErrorPercentage / 100));
+                        if (!value.empty()) counters.positions += detail::offsets_tried(text.size(), pattern_size, maxError);
+
+                        hits.clear();
+                        if (!value.empty()) packed::scan(text, *pattern, maxError, hits);
+                        for (const auto &hit : hits) {
+                            double percentage((((double)hit.error) / ((double)pattern_size)) * 100.0);
+                            for (std::size_t n = contigs.names_begin(contig); n < contigs.names_end(contig); n++) sink(contigs.name(n), record.header, value, percentage, strand);
+                        }
+                        ++pattern;
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * Même résultat et même ordre que find_approximate avec le même maxErrorPercentage et both_strands que le filtre :
+     * les motifs à graines ne sont comparés qu'aux positions proposées par filter, les autres à toutes les positions.
+     * Avec window non nul, les enregistrements sont lus par fenêtres et avec pool, les grandes séquences sont découpées
+     * en morceaux, comme pour find_exact. En nucl sans fenêtres, les séquences sont codées sur 2 bits (find_seeded_packed).
+     */
+    template<bool nucleic, typename Sink>
+    void find_seeded(const std::filesystem::path &file_path, const ContigSet &contigs, const SeedFilter &filter, Sink &&sink, std::size_t window = 0, ThreadPool *pool = nullptr) {
+        if constexpr (nucleic) {
+            if (window == 0) {
+                detail::find_seeded_packed(file_path, contigs, filter, sink, pool);
+                return;
+            }
+        }
+        // Occurrence en attente d'un enregistrement lu en plusieurs fenêtres.
+        struct Pending {
+            std::size_t pattern;
+            std::size_t start;
+            std::size_t error;
+        };
+        std::vector<Pending> pending;
+        std::size_t overlap(contigs.empty() ? 0 : contigs.length(contigs.size() - 1) - 1);
+
+        Reader reader(file_path);
+        Record record;
+        std::string sequence;
+        std::vector<SeedFilter::Candidate> candidates;
+        stats::Counters &counters(stats::local());
+        const auto &patterns(filter.patterns());
+        auto emit = [&](const SeedFilter::Pattern &pattern, std::size_t error, std::string_view text) -> void {
+            std::string_view value(nucleic ? pattern.sequence : text);
+            double percentage((((double)error) / ((double)pattern.sequence.size())) * 100.0);
+            for (std::size_t n = contigs.names_begin(pattern.contig); n < contigs.names_end(pattern.contig); n++) sink(contigs.name(n), record.header, value, percentage, pattern.strand);
+        };
+
+        // Vérifie les positions de text avant boundary, base étant la position de text dans l'enregistrement.
+        // Avec found nul, les occurrences sont signalées au fur et à mesure (enregistrement lu d'un bloc).
+        auto collect = [&](std::string_view text, std::size_t boundary, std::size_t base, std::vector<Pending> *found, std::vector<SeedFilter::Candidate> &seeds, stats::Counters &tally) -> void {
+            filter.candidates(text, seeds);
+            auto candidate(seeds.cbegin());
+            for (std::size_t id = 0; id < patterns.size(); id++) {
+                const SeedFilter::Pattern &pattern(patterns[id]);
+                std::size_t pattern_size(pattern.sequence.size()), maxError(pattern.max_error);
+                auto verify = [&](std::size_t start) -> void {
+                    if (start >= boundary) return;
+                    // La partie du contig qui dépasse la fin de la séquence compte comme autant d'erreurs.
+                    std::size_t inside(std::min(pattern_size, text.size() - start));
+                    std::size_t error(pattern_size - inside);
+                    if (error > maxError) return;
+                    tally.positions++;
+                    error += hamming::count(text.data() + start, pattern.sequence.data(), inside, maxError - error);
+                    if (error > maxError) return;
+                    if (found == nullptr) emit(pattern, error, text);
+                    else found->push_back({id, base + start, error});
+                };
+
+                if (pattern.seeded) {
+                    for (; candidate != seeds.cend() && candidate->pattern == id; ++candidate) verify(candidate->start);
+                }
+                else for (std::size_t start = 0; start < boundary; start++) verify(start);
+            }
+        };
+
+        std::vector<std::vector<Pending>> parts;
+        std::vector<std::vector<SeedFilter::Candidate>> part_candidates;
+        std::vector<stats::Counters> part_counters;
+        while (window == 0 ? reader.next(record) : reader.next_window(record, window, overlap)) {
+            if (record.start == 0) counters.records++;
+
+            // Seules les positions avant le recouvrement sont traitées, les suivantes le sont dans la fenêtre suivante.
+            std::size_t boundary(record.last ? record.sequence.size() : record.sequence.size() - overlap);
+            bool chunked(pool != nullptr && boundary >= 2 * detail::MIN_CHUNK);
+            if (record.start == 0 && record.last && !chunked) {
+                collect(record.sequence, boundary, 0, nullptr, candidates, counters);
+                continue;
+            }
+
+            if (chunked) {
+                // Chaque morceau a ses propres candidats et compteurs, ajoutés à ceux du thread appelant à la fin.
+                std::vector<detail::Chunk> chunks(detail::split(record.sequence.size(), boundary, overlap, pool->size()));
+                parts.assign(chunks.size(), std::vector<Pending>());
+                part_candidates.resize(chunks.size());
+                part_counters.assign(chunks.size(), stats::Counters());
+                for (std::size_t i = 0; i < chunks.size(); i++) {
+                    pool->submit([&, i]() -> void {
+                        const detail::Chunk &chunk(chunks[i]);
+                        collect(record.sequence.substr(chunk.begin, chunk.end - chunk.begin), chunk.boundary, record.start + chunk.begin, &parts[i], part_candidates[i], part_counters[i]);
+                    });
+                }
+                pool->wait();
+                for (std::size_t i = 0; i < chunks.size(); i++) {
+                    pending.insert(pending.end(), parts[i].begin(), parts[i].end());
+                    counters += part_counters[i];
+                }
+            }
+            else collect(record.sequence, boundary, record.start, &pending, candidates, counters);
+            if (!record.last || pending.empty()) continue;
+
+            std::stable_sort(pending.begin(), pending.end(), [](const Pending &a, const Pending &b) -> bool {
+                if (a.pattern != b.pattern) return a.pattern < b.pattern;
+                return a.start < b.start;
+            });
+            std::string_view text(record.sequence);
+            if constexpr (!nucleic) {
+                if (record.start != 0) {
+                    sequence = detail::read_sequence(file_path, record.offset);
+                    text = sequence;
+                }
+            }
+            for (const auto &current : pending) emit(patterns[current.pattern], current.error, text);
+            pending.clear();
+        }
+    }
+
+    /**
+     * Variante de find_seeded qui ne garde, pour chaque séquence de l'ensemble (brins confondus), que les best occurrences
+     * du fichier ayant le moins de différences ; à égalité, les premières du fichier (enregistrement, position, brin direct).
+     * Dès que best occurrences sont gardées, le nombre de différences accepté pour la séquence descend à celui de la moins
+     * bonne d'entre elles : la comparaison des positions suivantes s'arrête en général après quelques octets.
+     * Les occurrences gardées sont signalées à la fin du fichier, dans l'ordre de find_seeded. Avec window non nul, les
+     * enregistrements sont lus par fenêtres, le résultat ne dépend pas de leur taille.
+     */
+    template<bool nucleic, typename Sink>
+    void find_best(const std::filesystem::path &file_path, const ContigSet &contigs, const SeedFilter &filter, std::size_t best, Sink &&sink, std::size_t window = 0) {
+        if (best == 0) return;
+        struct Hit {
+            std::size_t error;
+            std::size_t record;  // indice dans records
+            std::size_t start;
+            std::size_t pattern;
+        };
+        // Enregistrement d'au moins une occurrence gardée, relu en prot pour écrire sa séquence.
+        struct Source {
+            std::string header;
+            std::size_t offset;
+        };
+        auto better = [](const Hit &a, const Hit &b) -> bool {
+            if (a.error != b.error) return a.error < b.error;
+            if (a.record != b.record) return a.record < b.record;
+            if (a.start != b.start) return a.start < b.start;
+            return a.pattern < b.pattern;
+        };
+
+        // Un tas par séquence de l'ensemble, la moins bonne occurrence gardée en tête.
+        std::vector<std::vector<Hit>> kept(contigs.size());
+        std::vector<Source> records;
+        std::size_t overlap(contigs.empty() ? 0 : contigs.length(contigs.size() - 1) - 1);
+
+        Reader reader(file_path);
+        Record record;
+        std::vector<SeedFilter::Candidate> candidates;
+        stats::Counters &counters(stats::local());
+        const auto &patterns(filter.patterns());
+        while (window == 0 ? reader.next(record) : reader.next_window(record, window, overlap)) {
+            if (record.start == 0) counters.records++;
+            std::string_view text(record.sequence);
+            std::size_t boundary(record.last ? text.size() : text.size() - overlap);
+            std::size_t slot(records.empty() || records.back().offset != record.offset ? records.size() : records.size() - 1);
+
+            // Garde hit s'il est meilleur que la moins bonne occurrence gardée, renvoie le nombre de différences accepté ensuite.
+            auto keep = [&](const Hit &hit, std::vector<Hit> &heap, std::size_t max_error) -> std::size_t {
+                if (heap.size() >= best) {
+                    if (!better(hit, heap.front())) return std::min(max_error, heap.front().error);
+                    std::pop_heap(heap.begin(), heap.end(), better);
+                    heap.back() = hit;
+                }
+                else heap.push_back(hit);
+                std::push_heap(heap.begin(), heap.end(), better);
+                if (slot == records.size()) records.push_back({std::string(record.header), record.offset});
+                return heap.size() < best ? max_error : std::min(max_error, heap.front().error);
+            };
+
+            filter.candidates(text, candidates);
+            auto candidate(candidates.cbegin());
+            for (std::size_t id = 0; id < patterns.size(); id++) {
+                const SeedFilter::Pattern &pattern(patterns[id]);
+                std::vector<Hit> &heap(kept[pattern.contig]);
+                std::size_t pattern_size(pattern.sequence.size());
+                // Nombre de différences accepté, revu seulement quand une occurrence est gardée.
+                std::size_t maxError(heap.size() < best ? pattern.max_error : std::min(pattern.max_error, heap.front().error));
+                // Différences du motif placé en start, le décompte s'arrête dès que maxError est dépassé.
+                auto errors = [&](std::size_t start) -> std::size_t {
+                    std::size_t inside(std::min(pattern_size, text.size() - start));
+                    std::size_t error(pattern_size - inside);
+                    if (error > maxError) return error;
+                    counters.positions++;
+                    return error + hamming::count(text.data() + start, pattern.sequence.data(), inside, maxError - error);
+                };
+
+                std::size_t error;
+                if (pattern.seeded) {
+                    for (; candidate != candidates.cend() && candidate->pattern == id; ++candidate) {
+                        std::size_t start(candidate->start);
+                        if (start < boundary && (error = errors(start)) <= maxError) maxError = keep({error, slot, record.start + start, id}, heap, pattern.max_error);
+                    }
+                }
+                else for (std::size_t start = 0; start < boundary; start++) {
+                    if ((error = errors(start)) <= maxError) maxError = keep({error, slot, record.start + start, id}, heap, pattern.max_error);
+                }
+            }
+        }
+
+        std::vector<Hit> hits;
+        for (const auto &heap : kept) hits.insert(hits.end(), heap.begin(), heap.end());
+        std::sort(hits.begin(), hits.end(), [](const Hit &a, const Hit &b) -> bool {
+            if (a.record != b.record) return a.record < b.record;
+            if (a.pattern != b.pattern) return a.pattern < b.pattern;
+            return a.start < b.start;
+        });
+
+        std::string sequence;
+        for (std::size_t i = 0; i < hits.size(); i++) {
+            const Hit &hit(hits[i]);
+            const SeedFilter::Pattern &pattern(patterns[hit.pattern]);
+            if constexpr (!nucleic) {
+                if (i == 0 || hits[i - 1].record != hit.record) sequence = detail::read_sequence(file_path, records[hit.record].offset);
+            }
+            std::string_view value(nucleic ? pattern.sequence : std::string_view(sequence));
+            double percentage((((double)hit.error) / ((double)pattern.sequence.size())) * 100.0);
+            for (std::size_t n = contigs.names_begin(pattern.contig); n < contigs.names_end(pattern.contig); n++) sink(contigs.name(n), records[hit.record].header, value, percentage, pattern.strand);
+        }
+    }
+
+    /**
+     * Recherche traduite de contigs protéiques dans un fichier de séquences nucléiques : chaque enregistrement est traduit
+     * dans ses six cadres de lecture (codon::translate), puis chaque cadre est parcouru par automaton (exact) ou vérifié
+     * aux positions proposées par filter (construit sans both_strands), comme le font find_exact et find_seeded en prot.
+     * sink(nameA, nameB, value, percentage, frame, begin, end) est appelé par cadre (+1, +2, +3, -1, -2, -3), puis dans
+     * l'ordre du moteur et pour chacun des noms ; begin et end (à partir de 1, inclus) délimitent les bases de
+     * l'occurrence sur le brin direct et value est cette partie de la séquence de l'enregistrement.
+     */
+    template<bool exact, typename Sink>
+    void find_translated(const std::filesystem::path &file_path, const ContigSet &contigs, const aho_corasick::Automaton &automaton, const SeedFilter &filter, Sink &&sink) {
+        Reader reader(file_path);
+        Record record;
+        std::string protein;
+        std::vector<SeedFilter::Candidate> candidates;
+        stats::Counters &counters(stats::local());
+
+        while (reader.next(record)) {
+            counters.records++;
+            std::size_t size(record.sequence.size());
+
+            for (int frame : {1, 2, 3, -1, -2, -3}) {
+                std::size_t shift((std::size_t) (frame > 0 ? frame : -frame) - 1);
+                if (frame > 0) codon::translate(record.sequence, shift, protein);
+                else codon::translate_reverse(record.sequence, shift, protein);
+
+                // Acides aminés [start, start + length) du cadre, ramenés aux bases du brin direct.
+                auto emit = [&](std::size_t contig, std::size_t start, std::size_t length, double percentage) -> void {
+                    std::size_t first(frame > 0 ? shift + 3 * start : size - shift - 3 * (start + length));
+                    std::string_view value(record.sequence.substr(first, 3 * length));
+                    for (std::size_t n = contigs.names_begin(contig); n < contigs.names_end(contig); n++) sink(contigs.name(n), record.header, value, percentage, frame, first + 1, first + 3 * length);
+                };
+
+                if constexpr (exact) {
+                    counters.positions += protein.size();
+                    automaton.search(protein, [&](std::size_t id, std::size_t start) -> void { emit(id, start, automaton.length(id), 0.0); });
+                }
+                else {
+                    filter.candidates(protein, candidates);
+                    const auto &patterns(filter.patterns());
+                    auto candidate(candidates.cbegin());
+                    for (std::size_t id = 0; id < patterns.size(); id++) {
+                        const SeedFilter::Pattern &pattern(patterns[id]);
+                        std::size_t pattern_size(pattern.sequence.size()), maxError(pattern.max_error);
+                        auto verify = [&](std::size_t start) -> void {
+                            // La partie du contig qui dépasse la fin du cadre compte comme autant d'erreurs.
+                            std::size_t inside(std::min(pattern_size, protein.size() - start));
+                            std::size_t error(pattern_size - inside);
+                            if (error > maxError) return;
+                            counters.positions++;
+                            error += hamming::count(protein.data() + start, pattern.sequence.data(), inside, maxError - error);
+                            if (error > maxError) return;
+                            emit(pattern.contig, start, inside, (((double)error) / ((double)pattern_size)) * 100.0);
+                        };
+
+                        if (pattern.seeded) {
+                            for (; candidate != candidates.cend() && candidate->pattern == id; ++candidate) verify(candidate->start);
+                        }
+                        else for (std::size_t start = 0; start < protein.size(); start++) verify(start);
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * Recherche avec au plus maxErrorPercentage % d'éditions (substitutions, insertions, délétions) par la distance de Myers.
+     * sink(nameA, nameB, value, percentage, strand, end, distance) est appelé par séquence de l'ensemble (brin direct en premier),
+     * puis par occurrence, puis pour chacun de ses noms ; end est la fin de l'occurrence dans la séquence de l'enregistrement
+     * (position de sa dernière base à partir de 1) et distance son nombre d'éditions. both_strands n'est utilisé qu'en nucl.
+     */
+    template<bool nucleic, typename Sink>
+    void find_edit(const std::filesystem::path &file_path, const ContigSet &contigs, int maxErrorPercentage, bool both_strands, Sink &&sink) {
+        // Pour chaque séquence, le brin direct puis éventuellement le complément inverse.
+        std::vector<std::string> reverse;
+        if (nucleic && both_strands) reverse = detail::reverse_contigs(contigs);
+        std::vector<myers::Pattern> patterns;
+        patterns.reserve(contigs.size() * 2);
+        for (std::size_t contig = 0; contig < contigs.size(); contig++) {
+            patterns.emplace_back(contigs.sequence(contig));
+            if (nucleic && both_strands) patterns.emplace_back(reverse[contig]);
+        }
+
+        Reader reader(file_path);
+        Record record;
+        std::vector<myers::Hit> hits;
+        stats::Counters &counters(stats::local());
+        while (reader.next(record)) {
+            counters.records++;
+
+            auto pattern(patterns.begin());
+            for (std::size_t contig = 0; contig < contigs.size(); contig++) {
+                for (char strand : {'+', '-'}) {
+                    if (strand == '-' && !(nucleic && both_strands)) break;
+                    std::string_view value;
+                    if constexpr (!nucleic) value = record.sequence;
+                    else value = strand == '+' ? contigs.sequence(contig) : std::string_view(reverse[contig]);
+                    std::size_t pattern_size(pattern->size());
+                    std::size_t maxError(pattern_size * (std::size_t) maxErrorPercentage / 100);
+
+                    hits.clear();
+                    if (pattern_size != 0 && (strand == '+' || !reverse[contig].empty())) {
+                        counters.positions += record.sequence.size();
+                        myers::search(record.sequence, *pattern, maxError, hits);
+                    }
+                    for (const auto &hit : hits) {
+                        double percentage((((double)hit.distance) / ((double)pattern_size)) * 100.0);
+                        for (std::size_t n = contigs.names_begin(contig); n < contigs.names_end(contig); n++) sink(contigs.name(n), record.header, value, percentage, strand, hit.end, hit.distance);
+                    }
+                    ++pattern;
+                }
+            }
+        }
+    }
+}
+
+#endif //CONTIGDIFF_FASTA_SEARCH_H
@@ -0,0 +1,23 @@
+//
+// Created by Florian Claisse on 17/10/2026.
+//
+
+#ifndef CONTIGDIFF_HAMMING_H
+#define CONTIGDIFF_HAMMING_H
+
+#include <cstddef>
+
+namespace hamming {
+    /**
+     * Compte les positions où a et b (de longueur size) diffèrent. Le calcul s'arrête dès que le
+     * nombre de différences dépasse budget : la valeur renvoyée est alors seulement garantie > budget.
+     * L'implémentation (AVX-512, AVX2, SSE2 avec popcnt, ou scalaire) est choisie au premier appel selon le processeur.
+     */
+    std::size_t count(const char *a, const char *b, std::size_t size, std::size_t budget);
+    /** Version scalaire de référence, même résultat que count(). */
+    std::size_t count_scalar(const char *a, const char *b, std::size_t size, std::size_t budget);
+    /** Nom du jeu d'instructions utilisé par count(). */
+    const char *isa();
+}
+
+#endif //CONTIGDIFF_HAMMING_H
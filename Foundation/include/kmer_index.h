@@ -0,0 +1,105 @@
+//
+// Created by Florian Claisse on 17/10/2026.
+//
+
+#ifndef CONTIGDIFF_KMER_INDEX_H
+#define CONTIGDIFF_KMER_INDEX_H
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "contig_set.h"
+#include "mapped_file.h"
+
+/**
+ * Index k-mer -> (fichier, enregistrement, position) d'un dossier de fichiers fasta nucléiques.
+ * Le fichier d'index est écrit une fois par build() puis projeté en mémoire par Index : un en-tête,
+ * la table des fichiers (nom, taille, date de modification), la table des enregistrements et enfin
+ * les entrées triées par k-mer. Seule une position sur step est indexée.
+ */
+namespace kmer_index {
+    struct Header {
+        char magic[8];
+        std::uint32_t k;
+        std::uint32_t step;
+        std::uint64_t file_count;
+        std::uint64_t record_count;
+        std::uint64_t entry_count;
+        std::uint64_t names_offset;
+        std::uint64_t files_offset;
+        std::uint64_t records_offset;
+        std::uint64_t entries_offset;
+    };
+
+    struct FileEntry {
+        std::uint64_t name_offset;
+        std::uint64_t name_length;
+        std::uint64_t size;
+        std::int64_t modified;
+        std::uint64_t first_record;
+        std::uint64_t record_count;
+    };
+
+    struct RecordEntry {
+        std::uint64_t offset; // position de l'en-tête dans le fichier fasta
+        std::uint64_t length; // longueur de la séquence
+    };
+
+    struct Entry {
+        std::uint64_t kmer;
+        std::uint32_t record;
+        std::uint32_t position;
+    };
+
+    /** Code 2 bits d'un k-mer (k <= 32), renvoie false s'il contient autre chose que A/C/G/T. */
+    bool encode(std::string_view kmer, std::uint64_t &code);
+
+    /** Indexe tous les fichiers fasta de directory dans le fichier output. */
+    int build(const std::filesystem::path &directory, const std::filesystem::path &output, unsigned k, unsigned step);
+
+    class Index {
+    public:
+        explicit Index(const std::filesystem::path &filePath);
+
+        /** Indique si le fichier est un index valide. */
+        bool is_valid() const { return header != nullptr; }
+        /** Indique si les fichiers indexés sont exactement les fichiers fasta actuels de directory, inchangés. */
+        bool is_current(const std::filesystem::path &directory) const;
+
+        unsigned k() const { return header->k; }
+        unsigned step() const { return header->step; }
+        std::size_t file_count() const { return header->file_count; }
+        std::string_view file_name(std::size_t file) const;
+        const FileEntry &file(std::size_t index) const { return files[index]; }
+        const RecordEntry &record(std::size_t index) const { return records[index]; }
+
+        /** Entrées [first, last) du k-mer donné. */
+        std::pair<const Entry*, const Entry*> lookup(std::uint64_t kmer) const;
+
+    private:
+        MappedFile mapped;
+        const Header *header;
+        const FileEntry *files;
+        const RecordEntry *records;
+        const Entry *entries;
+    };
+
+    /**
+     * Équivalent de fasta::find_contigs pour le fichier d'indice file de l'index : les contigs sont découpés en
+     * maxErrorPercentage * taille / 100 + 1 graines, les positions candidates viennent de l'index puis sont
+     * vérifiées sur la séquence. Les contigs trop courts pour être découpés sont cherchés sur toute la séquence.
+     * Avec both_strands, le complément inverse de chaque contig est aussi cherché et le brin ('+' ou '-') est transmis.
+     * Les résultats sont signalés par enregistrement, puis dans l'ordre des séquences de l'ensemble (brin direct en premier),
+     * puis par position, puis pour chaque nom de la séquence. Sans erreur permise, ils suivent dans chaque enregistrement
+     * l'ordre de fasta::find_exact (par position de fin). Les vues transmises ne restent valides que pendant l'appel.
+     */
+    void find_contigs(const Index &index, std::size_t file, const std::filesystem::path &filePath, const fasta::ContigSet &contigs, int maxErrorPercentage, bool both_strands, std::function<void(std::string_view, std::string_view, std::string_view, double, char)> func);
+    /** Équivalent de fasta::find_presence avec l'index : found[id] indique si la séquence id est présente dans le fichier. */
+    void find_presence(const Index &index, std::size_t file, const std::filesystem::path &filePath, const fasta::ContigSet &contigs, int maxErrorPercentage, bool both_strands, std::vector<bool> &found);
+}
+
+#endif //CONTIGDIFF_KMER_INDEX_H
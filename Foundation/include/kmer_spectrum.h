@@ -0,0 +1,81 @@
+//
+// Created by Florian Claisse on 17/10/2026.
+//
+
+#ifndef CONTIGDIFF_KMER_SPECTRUM_H
+#define CONTIGDIFF_KMER_SPECTRUM_H
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+class ThreadPool;
+
+/**
+ * Spectre des k-mers chevauchants (1 <= k <= 31) de fichiers fasta nucléiques, sous forme canonique : un k-mer et son
+ * complément inverse sont comptés ensemble sous le plus petit des deux codes 2 bits. Les k-mers contenant une base
+ * ambiguë sont ignorés. Le comptage est réparti entre les workers d'un pool qui partagent une table sans verrou.
+ */
+namespace kmer_spectrum {
+    const unsigned MAX_K = 31;
+
+    /** En-tête du format binaire, suivi de entry_count paires (k-mer, nombre) de 64 bits triées par k-mer. */
+    struct Header {
+        char magic[8];
+        std::uint32_t k;
+        std::uint32_t min_count;
+        std::uint64_t entry_count;
+    };
+
+    /** Paire (code 2 bits du k-mer canonique, nombre d'occurrences). */
+    typedef std::pair<std::uint64_t, std::uint64_t> Entry;
+
+    /**
+     * Table de hachage à adressage ouvert (sondage linéaire) k-mer -> nombre, partagée par plusieurs threads sans verrou :
+     * une case vide est réservée par compare-and-swap sur sa clé, puis son nombre est incrémenté atomiquement.
+     * La table ne grandit pas pendant les ajouts concurrents, l'appelant réserve la place nécessaire entre deux lots (reserve).
+     */
+    class Table {
+    public:
+        explicit Table(std::size_t capacity = 1 << 16);
+
+        Table(const Table&) = delete;
+        Table &operator=(const Table&) = delete;
+
+        /** Ajoute count occurrences de kmer. Utilisable depuis plusieurs threads. */
+        void add(std::uint64_t kmer, std::uint64_t count = 1);
+        /** Agrandit la table pour que additional nouveaux k-mers tiennent sous le taux de remplissage maximal. Pas pendant des ajouts. */
+        void reserve(std::size_t additional);
+
+        /** Nombre de k-mers distincts. */
+        std::size_t size() const { return used.load(std::memory_order_relaxed); }
+        std::size_t capacity() const { return mask + 1; }
+        /** Entrées d'au moins min_count occurrences, triées par k-mer. */
+        std::vector<Entry> sorted(std::uint64_t min_count) const;
+
+    private:
+        void rehash(std::size_t new_capacity);
+
+        std::unique_ptr<std::atomic<std::uint64_t>[]> keys; // k-mer + 1, 0 pour une case vide
+        std::unique_ptr<std::atomic<std::uint64_t>[]> counts;
+        std::size_t mask;
+        std::atomic<std::size_t> used;
+    };
+
+    /** Ajoute à table les k-mers canoniques des séquences de filePath. Le pool ne doit pas être utilisé par ailleurs pendant l'appel. */
+    int count(const std::filesystem::path &filePath, unsigned k, Table &table, ThreadPool &pool);
+
+    /** Texte du k-mer de code 2 bits kmer. */
+    std::string decode(std::uint64_t kmer, unsigned k);
+
+    /** Écrit les entrées au format TSV (k-mer, nombre), une par ligne. */
+    int write_tsv(const std::filesystem::path &output, const std::vector<Entry> &entries, unsigned k);
+    /** Écrit les entrées au format binaire (Header puis les paires). */
+    int write_binary(const std::filesystem::path &output, const std::vector<Entry> &entries, unsigned k, std::uint64_t min_count);
+}
+
+#endif //CONTIGDIFF_KMER_SPECTRUM_H
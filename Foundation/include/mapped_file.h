@@ -0,0 +1,38 @@
+//
+// Created by Florian Claisse on 17/10/2026.
+//
+
+#ifndef CONTIGDIFF_MAPPED_FILE_H
+#define CONTIGDIFF_MAPPED_FILE_H
+
+#include <cstdint>
+#include <filesystem>
+
+/** Fichier projeté en mémoire en lecture seule, libéré à la destruction. */
+class MappedFile {
+public:
+    MappedFile(): bytes(nullptr), length(0), opened(false) {}
+    explicit MappedFile(const std::filesystem::path &filePath, bool sequential = false);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile &operator=(const MappedFile&) = delete;
+
+    /** Indique si le fichier a pu être ouvert (un fichier vide est ouvert mais sans données). */
+    bool is_open() const { return opened; }
+    const char *data() const { return bytes; }
+    std::size_t size() const { return length; }
+
+    /**
+     * Indique si [offset, offset + size) tient dans [0, limit), sans dépassement de capacité : vérifie les positions
+     * et tailles lues dans un fichier avant de s'en servir (limit étant size() ou la taille d'une de ses tables).
+     */
+    static bool inside(std::uint64_t offset, std::uint64_t size, std::uint64_t limit) { return offset <= limit && size <= limit - offset; }
+
+private:
+    const char *bytes;
+    std::size_t length;
+    bool opened;
+};
+
+#endif //CONTIGDIFF_MAPPED_FILE_H
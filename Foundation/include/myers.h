@@ -0,0 +1,51 @@
+//
+// Created by Florian Claisse on 17/10/2026.
+//
+
+#ifndef CONTIGDIFF_MYERS_H
+#define CONTIGDIFF_MYERS_H
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+/**
+ * Distance d'édition semi-globale (substitutions, insertions et délétions) par l'algorithme bit-parallèle de
+ * Myers : le motif doit être aligné en entier, sur n'importe quelle partie du texte. Une colonne de la matrice
+ * de programmation dynamique est codée par ses différences verticales, 64 lignes par mot. Les motifs de plus de
+ * 64 bases sont découpés en blocs de 64 lignes calculés l'un après l'autre.
+ */
+namespace myers {
+    /** Motif prétraité : pour chaque octet, le masque des positions du motif qui lui sont égales, bloc par bloc. */
+    class Pattern {
+    public:
+        explicit Pattern(std::string_view sequence);
+
+        std::size_t size() const { return length; }
+        std::size_t blocks() const { return block_count; }
+        const std::uint64_t *peq(unsigned char c) const { return masks.data() + (std::size_t) c * block_count; }
+
+    private:
+        std::size_t length;
+        std::size_t block_count;
+        std::vector<std::uint64_t> masks;
+    };
+
+    /** Fin d'une occurrence (position exclue dans le texte) et nombre d'éditions. */
+    struct Hit {
+        std::size_t end;
+        std::size_t distance;
+    };
+
+    /**
+     * Ajoute à hits les occurrences de pattern dans text avec au plus maxDistance éditions. Des positions de fin
+     * consécutives acceptées forment une seule occurrence, signalée à sa meilleure fin (la première à distance minimale).
+     */
+    void search(std::string_view text, const Pattern &pattern, std::size_t maxDistance, std::vector<Hit> &hits);
+    /** Fin de la première position acceptée par search(), ou 0 si aucune. Le parcours s'arrête à cette position. */
+    std::size_t find(std::string_view text, const Pattern &pattern, std::size_t maxDistance);
+    /** Distance d'édition semi-globale de référence par programmation dynamique classique, pour les vérifications. */
+    std::size_t distance_scalar(std::string_view text, std::string_view pattern, std::size_t end);
+}
+
+#endif //CONTIGDIFF_MYERS_H
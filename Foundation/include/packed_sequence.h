@@ -0,0 +1,89 @@
+//
+// Created by Florian Claisse on 17/10/2026.
+//
+
+#ifndef CONTIGDIFF_PACKED_SEQUENCE_H
+#define CONTIGDIFF_PACKED_SEQUENCE_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace packed {
+    /** Suite de bases de même symbole hors A/C/G/T (N, bases ambiguës, '-'...). */
+    struct Run {
+        std::size_t start;
+        std::size_t length;
+        char symbol;
+    };
+
+    /**
+     * Séquence nucléique codée sur 2 bits par base (A=0, C=1, G=2, T=3), 32 bases par mot.
+     * Les positions qui ne sont pas A/C/G/T sont codées 0 et marquées dans un masque d'un bit par
+     * base, leur symbole est conservé dans une liste de suites. Sans exception le masque reste vide.
+     */
+    class Sequence {
+    public:
+        Sequence(): count(0) {}
+        explicit Sequence(std::string_view text): count(0) { append(text); }
+
+        /** Ajoute des bases à la fin, minuscules comprises. */
+        void append(std::string_view text);
+        void clear();
+
+        std::size_t size() const { return count; }
+        bool empty() const { return count == 0; }
+        /** Base à la position donnée, en majuscule. */
+        char at(std::size_t position) const;
+        /** Reconstitue le texte de la séquence. */
+        std::string unpack() const;
+        /** Remplace text par les bases [begin, begin + size), size étant réduit à la fin de la séquence. */
+        void unpack(std::size_t begin, std::size_t size, std::string &text) const;
+
+        /** 32 bases (64 bits) à partir de position, complétées par des zéros au-delà de la fin. */
+        std::uint64_t bases_at(std::size_t position) const;
+        /** Bits du masque des 32 bases à partir de position (un bit par base). */
+        std::uint32_t mask_at(std::size_t position) const;
+        bool has_exceptions() const { return !runs.empty(); }
+        /** Suites d'exceptions par position croissante. */
+        const std::vector<Run> &exception_runs() const { return runs; }
+        /** Mots de 32 bases suivis d'un mot nul, pour les boucles de comparaison. */
+        const std::uint64_t *word_data() const { return words.data(); }
+        std::size_t word_count() const { return words.size(); }
+
+    private:
+        std::vector<std::uint64_t> words;
+        std::vector<std::uint64_t> mask;
+        std::vector<Run> runs;
+        std::size_t count;
+    };
+
+    /**
+     * Compte les différences entre les size premières bases de pattern et text à partir de offset, par
+     * XOR/popcount sur 32 bases à la fois. Même résultat qu'une comparaison octet par octet des textes,
+     * le calcul s'arrête une fois budget dépassé (la valeur est alors seulement garantie > budget).
+     */
+    std::size_t mismatches(const Sequence &text, std::size_t offset, const Sequence &pattern, std::size_t size, std::size_t budget);
+
+    /** Position du contig dans le texte et nombre de différences. */
+    struct Hit {
+        std::size_t offset;
+        std::size_t error;
+    };
+
+    /**
+     * Ajoute à hits toutes les positions de text où pattern a au plus maxError différences, par position
+     * croissante. La partie du motif qui dépasse la fin du texte compte comme autant de différences.
+     * La boucle utilise l'instruction popcnt quand le processeur la fournit.
+     */
+    void scan(const Sequence &text, const Sequence &pattern, std::size_t maxError, std::vector<Hit> &hits);
+    /** Comme scan(), limité aux positions [begin, end) du texte (morceau d'un enregistrement). */
+    void scan(const Sequence &text, const Sequence &pattern, std::size_t maxError, std::size_t begin, std::size_t end, std::vector<Hit> &hits);
+    /** Première position trouvée par scan(), ou text.size() si aucune. Le parcours s'arrête à cette position. */
+    std::size_t find(const Sequence &text, const Sequence &pattern, std::size_t maxError);
+    /** Indique si pattern est présent en entier dans text à partir de offset. */
+    bool equal(const Sequence &text, std::size_t offset, const Sequence &pattern);
+}
+
+#endif //CONTIGDIFF_PACKED_SEQUENCE_H
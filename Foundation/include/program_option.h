@@ -5,6 +5,7 @@
 #ifndef CONTIGDIFF_PROGRAM_OPTION_H
 #define CONTIGDIFF_PROGRAM_OPTION_H
 
+#include <cstdint>
 #include <iostream>
 #include <vector>
 #include <filesystem>
@@ -12,6 +13,9 @@
 // Program name
 #define FINDALL "--findAll"
 #define CODONCOUNT "--codonCount"
+#define BUILDINDEX "--buildIndex"
+#define KMERCOUNT "--kmerCount"
+#define CONVERT "--convert"
 
 // Commande option
 #define INPUTA "--inputA"
@@ -19,10 +23,38 @@
 #define TYPE "--type"
 #define OUTPUT "--output"
 #define ACCEPT "--accept"
+#define THREADS "--threads"
+#define INDEX "--index"
+#define KMER "--kmer"
+#define STEP "--step"
+#define STRAND "--strand"
+#define STATS "--stats"
+#define PRESENCE "--presence"
+#define INDELS "--indels"
+#define MAXMEMORY "--max-memory"
+#define CACHE "--cache"
+#define TRANSLATE "--translate"
+#define SERVE "--serve"
+#define BEST "--best"
+#define MINCOUNT "--min-count"
+#define FORMAT "--format"
+#define PERFILE "--per-file"
+#define PACKED "--packed"
 
 #define PROTEIN "prot"
 #define NUCLEIC "nucl"
 
+#define FORWARD "forward"
+#define BOTH "both"
+
+#define ON "on"
+#define OFF "off"
+
+#define STDIN "-"
+
+#define TSV "tsv"
+#define BINARY "bin"
+
 namespace program_option {
     /** Permet à partir d'une ligne de commande de savoir quel programme est demandé et de l'envoyé vers le bon parser. */
     int parse(int argc, char *argv[]);
@@ -30,6 +62,12 @@ namespace program_option {
     int parse_find_all(const std::vector<std::string_view> &argv);
     /** Parse le ligne de commande reconnu comme etant pour le programme codon count. Une fois la commande parsé correctement le program est lancé. */
     int parse_codon_count(const std::vector<std::string_view> &argv);
+    /** Parse la ligne de commande reconnu comme etant pour le programme build index. Une fois la commande parsé correctement le program est lancé. */
+    int parse_build_index(const std::vector<std::string_view> &argv);
+    /** Parse la ligne de commande reconnu comme etant pour le programme kmer count. Une fois la commande parsé correctement le program est lancé. */
+    int parse_kmer_count(const std::vector<std::string_view> &argv);
+    /** Parse la ligne de commande reconnu comme etant pour le programme convert. Une fois la commande parsé correctement le program est lancé. */
+    int parse_convert(const std::vector<std::string_view> &argv);
 
     /** Affiche les usage pour la ligne de commande des programmes. */
     int usage();
@@ -37,6 +75,12 @@ namespace program_option {
     int find_all_usage();
     /** Affiche les usages pout le programme count_count */
     int codon_count_usage();
+    /** Affiche les usages pour le programme build_index. */
+    int build_index_usage();
+    /** Affiche les usages pour le programme kmer_count. */
+    int kmer_count_usage();
+    /** Affiche les usages pour le programme convert. */
+    int convert_usage();
 
     /** structure contenant les options necessaire pour le programme find all. */
     typedef struct {
@@ -45,12 +89,49 @@ namespace program_option {
         std::filesystem::path output;
         int accept;
         bool nucl; /* nucl | prot */
+        unsigned threads;
+        std::filesystem::path index; /* vide si aucun index */
+        bool both_strands; /* forward | both, nucl uniquement */
+        std::filesystem::path stats; /* vide si aucun rapport */
+        std::filesystem::path presence; /* vide hors mode présence */
+        bool indels; /* off | on, distance d'édition au lieu de la distance de Hamming */
+        std::size_t max_memory; /* octets de séquence lus à la fois par l'ensemble des threads, 0 sans limite */
+        std::filesystem::path cache; /* vide sans cache */
+        bool translate; /* off | on, contigs protéiques cherchés dans les six cadres de lecture de fichiers nucléiques */
+        std::filesystem::path serve; /* vide hors mode serveur, "-" pour l'entrée standard ou chemin d'une socket Unix */
+        std::size_t best; /* 0 pour toutes les occurrences, sinon nombre d'occurrences gardées par contig et par fichier */
     } FindAll;
 
     typedef struct {
         std::filesystem::path inputA;
         std::filesystem::path output;
     } CodonCount;
+
+    /** structure contenant les options necessaire pour le programme build index. */
+    typedef struct {
+        std::filesystem::path inputB;
+        std::filesystem::path output;
+        unsigned k;
+        unsigned step;
+    } BuildIndex;
+
+    /** structure contenant les options necessaire pour le programme kmer count. */
+    typedef struct {
+        std::filesystem::path inputB; /* dossier ou fichier fasta */
+        std::filesystem::path output; /* dossier des spectres */
+        unsigned k;
+        std::uint64_t min_count;
+        unsigned threads;
+        bool binary; /* tsv | bin */
+        bool per_file; /* off | on, un spectre par fichier en plus de celui de l'ensemble */
+    } KmerCount;
+
+    /** structure contenant les options necessaire pour le programme convert. */
+    typedef struct {
+        std::filesystem::path inputB; /* dossier ou fichier fasta */
+        std::filesystem::path output; /* dossier des conteneurs binaires */
+        bool packed; /* off | on, séquences nucléiques sans base ambiguë codées sur 2 bits */
+    } Convert;
 }
 
 #endif //CONTIGDIFF_PROGRAM_OPTION_H
@@ -0,0 +1,45 @@
+//
+// Created by Florian Claisse on 17/10/2026.
+//
+
+#ifndef CONTIGDIFF_RESULT_CACHE_H
+#define CONTIGDIFF_RESULT_CACHE_H
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+/**
+ * Cache des résultats par fichier du dossier B (--cache), adressé par contenu : la clé d'une entrée est l'empreinte
+ * du contenu du fichier et de la recherche (contigs, type, pourcentage...). Un fichier inchangé n'est donc pas
+ * recherché de nouveau, quel que soit son nom. Une entrée garde la ligne du fichier dans output.txt (sans son nom)
+ * et une copie de son fichier résultat. Chaque fichier d'une entrée est écrit sous un nom temporaire puis renommé,
+ * la ligne en dernier : une exécution interrompue ne laisse pas d'entrée incomplète.
+ */
+class ResultCache {
+public:
+    /** Cache désactivé. */
+    ResultCache() = default;
+    /** directory est créé au besoin. search identifie la recherche, deux recherches différentes ne partagent aucune entrée. */
+    ResultCache(std::filesystem::path directory, std::string search);
+
+    bool is_open() const { return !directory.empty(); }
+
+    /** Empreinte de data sur 128 bits en hexadécimal (non cryptographique). */
+    static std::string fingerprint(std::string_view data);
+    /** Empreinte du contenu d'un fichier, vide s'il ne peut pas être lu. */
+    static std::string file_fingerprint(const std::filesystem::path &filePath);
+
+    /** Clé de l'entrée d'un fichier du dossier B pour cette recherche, vide si le fichier ne peut pas être lu. */
+    std::string key(const std::filesystem::path &filePath) const;
+    /** Lit la ligne de l'entrée et, si result n'est pas vide, copie son fichier résultat vers result. Renvoie false si l'entrée n'existe pas. */
+    bool load(const std::string &key, std::string &row, const std::filesystem::path &result) const;
+    /** Enregistre l'entrée, avec une copie de result s'il n'est pas vide. Renvoie false en cas d'échec. */
+    bool store(const std::string &key, std::string_view row, const std::filesystem::path &result) const;
+
+private:
+    std::filesystem::path directory;
+    std::string search;
+};
+
+#endif //CONTIGDIFF_RESULT_CACHE_H
@@ -0,0 +1,77 @@
+//
+// Created by Florian Claisse on 17/10/2026.
+//
+
+#ifndef CONTIGDIFF_RESULT_WRITER_H
+#define CONTIGDIFF_RESULT_WRITER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Écriture asynchrone des fichiers résultats.
+ * Les moteurs de recherche accumulent leurs résultats dans un lot (une chaîne) puis le confient au
+ * writer : un thread dédié l'écrit dans le fichier, qui a son propre tampon et n'est vidé qu'à sa fermeture.
+ * La quantité de lots en attente est bornée, un producteur plus rapide que le disque finit par attendre.
+ */
+class ResultWriter {
+public:
+    typedef std::size_t Output;
+
+    /** buffer_size : tampon de chaque fichier, pending_limit : octets en attente au-delà desquels write() attend. */
+    explicit ResultWriter(std::size_t buffer_size = 1 << 20, std::size_t pending_limit = 64 << 20);
+    /** Ferme les fichiers encore ouverts et arrête le thread d'écriture. */
+    ~ResultWriter();
+
+    ResultWriter(const ResultWriter&) = delete;
+    ResultWriter &operator=(const ResultWriter&) = delete;
+
+    /** Ouvre (et vide) un fichier de sortie. Utilisable depuis plusieurs threads. */
+    Output open(const std::filesystem::path &path);
+    /** Confie un lot de texte à écrire à la suite du fichier. */
+    void write(Output output, std::string &&batch);
+    /** Ferme le fichier une fois ses lots écrits. */
+    void close(Output output);
+    /** Attend que tous les lots soumis soient écrits et les fichiers demandés fermés. */
+    void drain();
+    /** Indique si une ouverture ou une écriture a échoué. */
+    bool failed() const { return failure; }
+
+private:
+    struct Task {
+        Output output;
+        std::string data;
+        enum { OPEN, WRITE, CLOSE } kind;
+        std::filesystem::path path;
+    };
+    struct File {
+        std::ofstream stream;
+        std::unique_ptr<char[]> buffer;
+    };
+
+    void push(Task &&task);
+    void run();
+
+    std::size_t buffer_size;
+    std::size_t pending_limit;
+    std::size_t pending_bytes;
+    std::vector<std::unique_ptr<File>> files;
+    std::deque<Task> tasks;
+    std::mutex mutex;
+    std::condition_variable task_available;
+    std::condition_variable space_available;
+    bool busy;
+    bool stopping;
+    std::atomic<bool> failure;
+    std::thread worker;
+};
+
+#endif //CONTIGDIFF_RESULT_WRITER_H
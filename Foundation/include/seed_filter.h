@@ -0,0 +1,74 @@
+//
+// Created by Florian Claisse on 17/10/2026.
+//
+
+#ifndef CONTIGDIFF_SEED_FILTER_H
+#define CONTIGDIFF_SEED_FILTER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "aho_corasick.h"
+#include "contig_set.h"
+
+namespace fasta {
+    /**
+     * Filtre par graines (principe des tiroirs) pour la recherche avec au plus k différences : chaque motif est découpé
+     * en k + 1 morceaux disjoints, une occurrence en contient forcément un sans erreur. Tous les morceaux sont cherchés
+     * en un seul parcours par un automate, seules les positions qu'ils impliquent sont ensuite vérifiées.
+     * Les motifs dont les morceaux seraient plus courts que MIN_SEED sont cherchés à toutes les positions.
+     */
+    class SeedFilter {
+    public:
+        static const std::size_t MIN_SEED = 8;
+
+        /** Séquence cherchée : une séquence de l'ensemble ou son complément inverse. */
+        struct Pattern {
+            std::size_t contig;
+            char strand;
+            std::string_view sequence;
+            std::size_t max_error;
+            bool seeded;
+        };
+
+        /** Position à vérifier : motif (indice dans patterns()) placé en start. */
+        struct Candidate {
+            std::size_t pattern;
+            std::size_t start;
+        };
+
+        SeedFilter() = default;
+        /** Les compléments inverses ne sont ajoutés qu'avec both_strands (palindromes exceptés), à la suite de leur séquence. */
+        SeedFilter(const ContigSet &contigs, int maxErrorPercentage, bool both_strands);
+
+        SeedFilter(const SeedFilter&) = delete;
+        SeedFilter &operator=(const SeedFilter&) = delete;
+        SeedFilter(SeedFilter&&) = default;
+        SeedFilter &operator=(SeedFilter&&) = default;
+
+        /** Motifs par séquence de l'ensemble, brin direct en premier. */
+        const std::vector<Pattern> &patterns() const { return list; }
+        /** Remplace candidates par les positions de text à vérifier pour les motifs à graines, triées par motif puis position. */
+        void candidates(std::string_view text, std::vector<Candidate> &candidates) const;
+        /**
+         * Ajoute à candidates, sans les trier, les positions impliquées par les graines de text qui commencent avant limit,
+         * base étant la position de text dans la séquence : une séquence peut ainsi être parcourue par blocs consécutifs
+         * de limit octets, chacun prolongé de longest_seed() - 1 octets. Les positions sont celles de la séquence.
+         */
+        void add_candidates(std::string_view text, std::size_t base, std::size_t limit, std::vector<Candidate> &candidates) const;
+        /** Trie les positions par motif puis position et retire les doublons. */
+        static void sort_candidates(std::vector<Candidate> &candidates);
+        /** Longueur de la plus longue graine. */
+        std::size_t longest_seed() const { return longest; }
+
+    private:
+        std::vector<std::string> reverse;
+        std::vector<Pattern> list;
+        std::vector<Candidate> seeds; // graine -> (motif, position de la graine dans le motif)
+        aho_corasick::Automaton automaton;
+        std::size_t longest = 0;
+    };
+}
+
+#endif //CONTIGDIFF_SEED_FILTER_H
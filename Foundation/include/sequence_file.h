@@ -0,0 +1,108 @@
+//
+// Created by Florian Claisse on 17/10/2026.
+//
+
+#ifndef CONTIGDIFF_SEQUENCE_FILE_H
+#define CONTIGDIFF_SEQUENCE_FILE_H
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "mapped_file.h"
+
+namespace fasta {
+    /** Extension des conteneurs binaires de séquences. */
+    const std::string SEQUENCE_FILE_EXTENSION("fastabin");
+
+    /**
+     * En-tête d'un conteneur binaire de séquences (.fastabin), qui remplace le format texte fastaline. Il est suivi de
+     * la table des enregistrements (dans l'ordre du fichier fasta), des indices des enregistrements triés par nom, des
+     * en-têtes bout à bout puis des séquences, chacune alignée sur 8 octets.
+     */
+    struct SequenceHeader {
+        char magic[8];
+        std::uint64_t record_count;
+        std::uint64_t records_offset;
+        std::uint64_t order_offset;
+        std::uint64_t names_offset;
+        std::uint64_t data_offset;
+        std::uint64_t size;           // taille du fichier
+    };
+
+    struct SequenceEntry {
+        std::uint64_t name_offset;    // en-tête ('>' compris) depuis names_offset
+        std::uint64_t name_length;
+        std::uint64_t sequence_offset;// depuis le début du fichier
+        std::uint64_t length;         // nombre de bases
+        std::uint64_t checksum;       // FNV-1a 64 bits du texte de la séquence en majuscules
+        std::uint32_t packed;         // 1 : 2 bits par base (A=0, C=1, G=2, T=3), 32 bases par mot ; 0 : un octet par base
+        std::uint32_t reserved;
+    };
+
+    /**
+     * Conteneur binaire projeté en mémoire : les enregistrements sont lus à la demande, sans analyser de texte.
+     * Une séquence sur 8 bits est renvoyée directement depuis le fichier, une séquence sur 2 bits est décodée dans
+     * le tampon de l'appelant. Un conteneur invalide (magic, positions ou tailles hors du fichier) est vu comme vide.
+     * La somme de contrôle d'un enregistrement est vérifiée à sa première lecture (verify), pas à l'ouverture : un
+     * chargement partiel ne lit que les séquences demandées.
+     */
+    class SequenceFile {
+    public:
+        /** Projette le fichier filePath. */
+        explicit SequenceFile(const std::filesystem::path &filePath);
+        /** Vue sur un conteneur déjà projeté par l'appelant, qui doit rester valide. */
+        SequenceFile(const char *data, std::size_t size);
+
+        SequenceFile(const SequenceFile&) = delete;
+        SequenceFile &operator=(const SequenceFile&) = delete;
+
+        /** Indique si les octets commencent par la signature d'un conteneur, valide ou non. */
+        static bool has_magic(const char *data, std::size_t size);
+        /**
+         * Écrit le conteneur output des enregistrements du fichier filePath. Avec packed, les séquences qui ne contiennent
+         * que A/C/G/T sont codées sur 2 bits, les autres (protéines, bases ambiguës) restent sur 8 bits.
+         * Le fichier est lu deux fois, la mémoire utilisée ne dépend pas de la taille des séquences.
+         */
+        static int write(const std::filesystem::path &filePath, const std::filesystem::path &output, bool packed);
+        /** Somme de contrôle enregistrée pour une séquence, hash permettant de la calculer par morceaux successifs. */
+        static std::uint64_t checksum(std::string_view sequence, std::uint64_t hash = 0xcbf29ce484222325ULL);
+
+        bool is_valid() const { return header != nullptr; }
+        /** Nombre d'enregistrements. */
+        std::size_t size() const { return header == nullptr ? 0 : header->record_count; }
+        const SequenceEntry &entry(std::size_t index) const { return entries[index]; }
+        std::string_view name(std::size_t index) const { return {data + header->names_offset + entries[index].name_offset, entries[index].name_length}; }
+        std::size_t length(std::size_t index) const { return entries[index].length; }
+
+        /** Position de l'entrée index dans le fichier : identifie l'enregistrement (Record::offset). */
+        std::size_t entry_offset(std::size_t index) const { return header->records_offset + index * sizeof(SequenceEntry); }
+        /** Enregistrement dont l'entrée est à la position offset, size() si offset n'est pas une entrée. */
+        std::size_t index_at(std::size_t offset) const;
+        /** Premier enregistrement d'en-tête name ('>' compris) par recherche dichotomique, size() s'il n'existe pas. */
+        std::size_t find(std::string_view name) const;
+
+        /** Bases [begin, begin + count) de la séquence index, count étant réduit à la fin de la séquence. */
+        std::string_view sequence(std::size_t index, std::size_t begin, std::size_t count, std::string &buffer) const;
+        std::string_view sequence(std::size_t index, std::string &buffer) const { return sequence(index, 0, length(index), buffer); }
+        /** Vérifie la somme de contrôle de la séquence index, calculée une seule fois par enregistrement. */
+        bool verify(std::size_t index) const;
+
+    private:
+        enum Check : std::uint8_t { UNCHECKED, VALID, CORRUPTED };
+
+        void open();
+
+        MappedFile mapped;
+        const char *data;
+        std::size_t bytes;
+        const SequenceHeader *header;
+        const SequenceEntry *entries;
+        const std::uint64_t *order;
+        mutable std::vector<Check> checked;
+    };
+}
+
+#endif //CONTIGDIFF_SEQUENCE_FILE_H
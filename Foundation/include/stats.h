@@ -0,0 +1,95 @@
+//
+// Created by Florian Claisse on 17/10/2026.
+//
+
+#ifndef CONTIGDIFF_STATS_H
+#define CONTIGDIFF_STATS_H
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * Mesures d'exécution (--stats) : durée des phases, compteurs par fichier et mémoire maximale.
+ * Les moteurs de recherche incrémentent les compteurs du thread courant (stats::local()), ce qui ne
+ * coûte qu'une addition par enregistrement. L'appelant les remet à zéro avant un fichier et les relève après.
+ */
+namespace stats {
+    struct Counters {
+        std::uint64_t bytes = 0;     // octets lus
+        std::uint64_t records = 0;   // enregistrements parcourus
+        std::uint64_t positions = 0; // positions candidates examinées
+        std::uint64_t hits = 0;      // résultats signalés
+
+        Counters &operator+=(const Counters &other);
+    };
+
+    /** Compteurs du thread courant. */
+    Counters &local();
+
+    struct FileStats {
+        std::string name;
+        double seconds;
+        Counters counters;
+    };
+
+    /** Rapport d'exécution, utilisable depuis plusieurs threads. */
+    class Report {
+    public:
+        explicit Report(std::string command);
+
+        void add_phase(const std::string &name, double seconds);
+        void add_file(FileStats file);
+        /** Ajoute une valeur au premier niveau du rapport. Renvoie false sans rien ajouter si name est une clé déjà écrite par write(). */
+        bool set(const std::string &name, std::uint64_t value);
+
+        /** Écrit le rapport au format JSON. Les fichiers sont triés par nom. */
+        int write(const std::filesystem::path &path) const;
+
+    private:
+        mutable std::mutex mutex;
+        std::string command;
+        std::chrono::steady_clock::time_point begin;
+        std::vector<std::pair<std::string, double>> phases;
+        std::vector<std::pair<std::string, std::uint64_t>> values;
+        std::vector<FileStats> files;
+    };
+
+    /** Chronomètre démarré à sa création. */
+    class Stopwatch {
+    public:
+        Stopwatch(): begin(std::chrono::steady_clock::now()) {}
+
+        /** Secondes écoulées depuis la création. */
+        double elapsed() const { return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count(); }
+
+    private:
+        std::chrono::steady_clock::time_point begin;
+    };
+
+    /** Chronomètre une portée et ajoute sa durée comme phase du rapport (rien si report est nul). */
+    class ScopedTimer {
+    public:
+        ScopedTimer(Report *report, std::string name);
+        ~ScopedTimer();
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer &operator=(const ScopedTimer&) = delete;
+
+        /** Secondes écoulées depuis la création. */
+        double elapsed() const { return stopwatch.elapsed(); }
+
+    private:
+        Report *report;
+        std::string name;
+        Stopwatch stopwatch;
+    };
+
+    /** Mémoire résidente maximale du processus en kilo-octets. */
+    std::uint64_t peak_rss_kb();
+}
+
+#endif //CONTIGDIFF_STATS_H
@@ -0,0 +1,61 @@
+//
+// Created by Florian Claisse on 17/10/2026.
+//
+
+#ifndef CONTIGDIFF_THREAD_POOL_H
+#define CONTIGDIFF_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Pool de threads à vol de tâches.
+ * Chaque worker possède sa file, les tâches soumises sont distribuées à tour de rôle et exécutées
+ * dans leur ordre de soumission. Un worker dont la file est vide vole la tâche la plus ancienne
+ * d'un autre worker, soumettre les tâches les plus lourdes en premier équilibre donc la charge.
+ */
+class ThreadPool {
+public:
+    /** Crée le pool avec threads workers (au moins un). */
+    explicit ThreadPool(std::size_t threads);
+    /** Attend la fin de toutes les tâches puis arrête les workers. */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool &operator=(const ThreadPool&) = delete;
+
+    /** Ajoute une tâche. Peut être appelé depuis une tâche en cours. */
+    void submit(std::function<void()> task);
+    /** Bloque jusqu'à ce que toutes les tâches soumises soient terminées. */
+    void wait();
+
+    std::size_t size() const { return queues.size(); }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void work(std::size_t index);
+    bool pop(std::size_t index, std::function<void()> &task);
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<std::size_t> next_queue;
+
+    std::mutex state_mutex;
+    std::condition_variable work_available;
+    std::condition_variable all_done;
+    std::size_t pending;  // tâches soumises et non terminées
+    std::size_t queued;   // tâches en attente dans les files
+    bool stopping;
+};
+
+#endif //CONTIGDIFF_THREAD_POOL_H
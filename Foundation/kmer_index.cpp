@@ -0,0 +1,377 @@
+//
+// Created by Florian Claisse on 17/10/2026.
+//
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include "include/kmer_index.h"
+#include "include/fasta.h"
+#include "include/fasta_search.h"
+#include "include/directory.h"
+#include "include/hamming.h"
+#include "include/stats.h"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+static const char MAGIC[8] = {'C', 'T', 'G', 'I', 'D', 'X', '1', '\0'};
+
+static int8_t base_code(char c) {
+    switch (c) {
+        case 'A': return 0;
+        case 'C': return 1;
+        case 'G': return 2;
+        case 'T': return 3;
+        default: return -1;
+    }
+}
+
+static uint64_t align8(uint64_t value) {
+    return (value + 7) & ~(uint64_t) 7;
+}
+
+static int64_t modified_time(const fs::path &filePath) {
+    return (int64_t) fs::last_write_time(filePath).time_since_epoch().count();
+}
+
+bool kmer_index::encode(string_view kmer, uint64_t &code) {
+    code = 0;
+    for (const char c : kmer) {
+        int8_t base(base_code(c));
+        if (base < 0) return false;
+        code = (code << 2) | (uint64_t) base;
+    }
+    return true;
+}
+
+int kmer_index::build(const fs::path &directory, const fs::path &output, unsigned k, unsigned step) {
+    if (k == 0 || k > 32 || step == 0) return EXIT_FAILURE;
+    uint64_t kmer_mask(k == 32 ? ~(uint64_t) 0 : (((uint64_t) 1 << (2 * k)) - 1));
+
+    vector<fs::path> paths(fasta::input_files(directory));
+    vector<FileEntry> files;
+    vector<RecordEntry> records;
+    vector<Entry> entries;
+    string names;
+
+    for (const auto &path : paths) {
+        string name(directory::fileName(path));
+        files.push_back({names.size(), name.size(), (uint64_t) fs::file_size(path), modified_time(path), records.size(), 0});
+        names += name;
+
+        fasta::Reader reader(path);
+        if (!reader.is_open()) return EXIT_FAILURE;
+        fasta::Record record;
+        while (reader.next(record)) {
+            if (record.sequence.size() > UINT32_MAX || records.size() >= UINT32_MAX) return EXIT_FAILURE;
+            uint32_t record_index((uint32_t) records.size());
+            records.push_back({record.offset, record.sequence.size()});
+
+            // k-mer glissant, remis à zéro à chaque base hors A/C/G/T.
+            uint64_t code(0);
+            size_t valid(0);
+            for (size_t i = 0; i < record.sequence.size(); i++) {
+                int8_t base(base_code(record.sequence[i]));
+                if (base < 0) {
+                    valid = 0;
+                    continue;
+                }
+                code = ((code << 2) | (uint64_t) base) & kmer_mask;
+                if (++valid < k) continue;
+                size_t position(i + 1 - k);
+                if (position % step == 0) entries.push_back({code, record_index, (uint32_t) position});
+            }
+        }
+        files.back().record_count = records.size() - files.back().first_record;
+    }
+
+    sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) -> bool {
+        if (a.kmer != b.kmer) return a.kmer < b.kmer;
+        if (a.record != b.record) return a.record < b.record;
+        return a.position < b.position;
+    });
+
+    Header header{};
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.k = k;
+    header.step = step;
+    header.file_count = files.size();
+    header.record_count = records.size();
+    header.entry_count = entries.size();
+    header.names_offset = sizeof(Header);
+    header.files_offset = align8(header.names_offset + names.size());
+    header.records_offset = header.files_offset + files.size() * sizeof(FileEntry);
+    header.entries_offset = header.records_offset + records.size() * sizeof(RecordEntry);
+
+    ofstream outputFile;
+    outputFile.open(output, ios::binary | ios::trunc);
+    if (!outputFile.is_open()) return EXIT_FAILURE;
+    outputFile.write((const char*) &header, sizeof(Header));
+    outputFile.write(names.data(), (streamsize) names.size());
+    outputFile.write("\0\0\0\0\0\0\0", (streamsize) (header.files_offset - header.names_offset - names.size()));
+    outputFile.write((const char*) files.data(), (streamsize) (files.size() * sizeof(FileEntry)));
+    outputFile.write((const char*) records.data(), (streamsize) (records.size() * sizeof(RecordEntry)));
+    outputFile.write((const char*) entries.data(), (streamsize) (entries.size() * sizeof(Entry)));
+    outputFile.close();
+
+    return outputFile.fail() ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+kmer_index::Index::Index(const fs::path &filePath): mapped(filePath), header(nullptr), files(nullptr), records(nullptr), entries(nullptr) {
+    uint64_t bytes(mapped.size());
+    if (bytes < sizeof(Header)) return;
+    const Header *candidate((const Header*) mapped.data());
+    if (memcmp(candidate->magic, MAGIC, sizeof(MAGIC)) != 0) return;
+    if (candidate->k == 0 || candidate->k > 32 || candidate->step == 0) return;
+
+    // Les tables se suivent dans l'ordre de build(), alignées sur 8 octets, les entrées allant jusqu'à la fin du fichier.
+    uint64_t file_count(candidate->file_count), record_count(candidate->record_count), entry_count(candidate->entry_count);
+    if (file_count > bytes / sizeof(FileEntry) || record_count > bytes / sizeof(RecordEntry) || entry_count > bytes / sizeof(Entry)) return;
+    if (candidate->names_offset < sizeof(Header) || candidate->names_offset > candidate->files_offset) return;
+    if (candidate->files_offset % 8 != 0 || !MappedFile::inside(candidate->files_offset, file_count * sizeof(FileEntry), candidate->records_offset)) return;
+    if (candidate->records_offset % 8 != 0 || !MappedFile::inside(candidate->records_offset, record_count * sizeof(RecordEntry), candidate->entries_offset)) return;
+    if (candidate->entries_offset % 8 != 0 || !MappedFile::inside(candidate->entries_offset, entry_count * sizeof(Entry), bytes) || candidate->entries_offset + entry_count * sizeof(Entry) != bytes) return;
+
+    // Les noms et les plages d'enregistrements des fichiers sont vérifiés une fois ici : les lectures suivantes ne sortent pas du fichier.
+    const FileEntry *table((const FileEntry*) (mapped.data() + candidate->files_offset));
+    uint64_t names_size(candidate->files_offset - candidate->names_offset);
+    for (uint64_t i = 0; i < file_count; i++) {
+        if (!MappedFile::inside(table[i].name_offset, table[i].name_length, names_size)) return;
+        if (!MappedFile::inside(table[i].first_record, table[i].record_count, record_count)) return;
+    }
+
+    header = candidate;
+    files = table;
+    records = (const RecordEntry*) (mapped.data() + header->records_offset);
+    entries = (const Entry*) (mapped.data() + header->entries_offset);
+}
+
+string_view kmer_index::Index::file_name(size_t file) const {
+    return {mapped.data() + header->names_offset + files[file].name_offset, files[file].name_length};
+}
+
+bool kmer_index::Index::is_current(const fs::path &directory) const {
+    vector<fs::path> paths(fasta::input_files(directory));
+    if (paths.size() != file_count()) return false;
+    for (size_t i = 0; i < paths.size(); i++) {
+        if (directory::fileName(paths[i]) != file_name(i)) return false;
+        if (fs::file_size(paths[i]) != files[i].size || modified_time(paths[i]) != files[i].modified) return false;
+    }
+    return true;
+}
+
+pair<const kmer_index::Entry*, const kmer_index::Entry*> kmer_index::Index::lookup(uint64_t kmer) const {
+    const Entry *end(entries + header->entry_count);
+    const Entry *first(lower_bound(entries, end, kmer, [](const Entry &entry, uint64_t value) -> bool { return entry.kmer < value; }));
+    const Entry *last(upper_bound(first, end, kmer, [](uint64_t value, const Entry &entry) -> bool { return value < entry.kmer; }));
+    return {first, last};
+}
+
+/** Nombre d'erreurs du contig placé en start, la partie qui dépasse la séquence comptant comme autant d'erreurs. */
+static size_t errors_at(string_view text, string_view pattern, size_t start, size_t maxError) {
+    size_t overlap(min(pattern.size(), text.size() - start));
+    size_t error(pattern.size() - overlap);
+    if (error > maxError) return error;
+    return error + hamming::count(text.data() + start, pattern.data(), overlap, maxError - error);
+}
+
+/** Séquence cherchée : un contig de l'ensemble ou son complément inverse. */
+struct Pattern {
+    size_t contig; // identifiant de la séquence dans l'ensemble
+    string_view sequence;
+    char strand;
+};
+
+struct Candidate {
+    size_t record;
+    size_t contig; // indice dans patterns
+    size_t start;
+};
+
+/** Motifs cherchés dans un fichier de l'index, positions candidates triées et enregistrements à relire. */
+struct Plan {
+    vector<string> reverse;
+    vector<Pattern> patterns;
+    vector<size_t> max_errors;
+    vector<size_t> fallback; // motifs trop courts pour être découpés en graines
+    vector<Candidate> candidates;
+    vector<uint32_t> visited;
+};
+
+static Plan make_plan(const kmer_index::Index &index, size_t file, const fasta::ContigSet &contigs, int maxErrorPercentage, bool both_strands) {
+    Plan plan;
+
+    // Chaque séquence, suivie de son complément inverse s'il est cherché (sauf palindrome).
+    if (both_strands) plan.reverse = fasta::detail::reverse_contigs(contigs);
+    for (size_t contig = 0; contig < contigs.size(); contig++) {
+        plan.patterns.push_back({contig, contigs.sequence(contig), '+'});
+        if (both_strands && !plan.reverse[contig].empty()) plan.patterns.push_back({contig, plan.reverse[contig], '-'});
+    }
+
+    const kmer_index::FileEntry &entry(index.file(file));
+    uint32_t first_record((uint32_t) entry.first_record), last_record((uint32_t) (entry.first_record + entry.record_count));
+    unsigned k(index.k()), step(index.step());
+
+    for (size_t id = 0; id < plan.patterns.size(); id++) {
+        string_view sequence(plan.patterns[id].sequence);
+        size_t size(sequence.size());
+        plan.max_errors.push_back(size * (size_t) maxErrorPercentage / 100);
+
+        // Principe des tiroirs : avec au plus maxError erreurs, une des maxError + 1 graines est exacte.
+        size_t pieces(plan.max_errors.back() + 1), piece(size / pieces);
+        vector<pair<uint64_t, size_t>> seeds;
+        bool seedable(piece >= k + step - 1);
+        for (size_t p = 0; seedable && p < pieces; p++) {
+            // Une des step positions de la graine tombe sur une position indexée.
+            for (size_t j = 0; seedable && j < step; j++) {
+                uint64_t code;
+                size_t offset(p * piece + j);
+                seedable = kmer_index::encode(sequence.substr(offset, k), code);
+                seeds.emplace_back(code, offset);
+            }
+        }
+        if (!seedable) {
+            plan.fallback.push_back(id);
+            continue;
+        }
+
+        for (const auto &seed : seeds) {
+            auto range(index.lookup(seed.first));
+            const kmer_index::Entry *hit(lower_bound(range.first, range.second, first_record, [](const kmer_index::Entry &current, uint32_t value) -> bool { return current.record < value; }));
+            for (; hit != range.second && hit->record < last_record; hit++) {
+                if (hit->position < seed.second) continue;
+                plan.candidates.push_back({hit->record, id, hit->position - seed.second});
+            }
+        }
+    }
+
+    auto &candidates(plan.candidates);
+    sort(candidates.begin(), candidates.end(), [](const Candidate &a, const Candidate &b) -> bool {
+        if (a.record != b.record) return a.record < b.record;
+        if (a.contig != b.contig) return a.contig < b.contig;
+        return a.start < b.start;
+    });
+    candidates.erase(unique(candidates.begin(), candidates.end(), [](const Candidate &a, const Candidate &b) -> bool {
+        return a.record == b.record && a.contig == b.contig && a.start == b.start;
+    }), candidates.end());
+
+    // Sans contig de repli, seuls les enregistrements qui ont des candidats sont relus.
+    if (plan.fallback.empty()) {
+        for (const auto &candidate : candidates) {
+            if (plan.visited.empty() || plan.visited.back() != candidate.record) plan.visited.push_back((uint32_t) candidate.record);
+        }
+    }
+    else for (uint32_t current = first_record; current < last_record; current++) plan.visited.push_back(current);
+
+    return plan;
+}
+
+void kmer_index::find_contigs(const Index &index, size_t file, const fs::path &filePath, const fasta::ContigSet &contigs, int maxErrorPercentage, bool both_strands, function<void(string_view, string_view, string_view, double, char)> func) {
+    Plan plan(make_plan(index, file, contigs, maxErrorPercentage, both_strands));
+    const auto &patterns(plan.patterns);
+    const auto &max_errors(plan.max_errors);
+    bool exact(maxErrorPercentage == 0);
+
+    fasta::Reader reader(filePath);
+    fasta::Record record;
+    vector<Candidate> hits;
+    vector<size_t> errors;
+    auto next_candidate(plan.candidates.cbegin());
+
+    stats::Counters &counters(stats::local());
+    for (uint32_t current : plan.visited) {
+        reader.seek(index.record(current).offset);
+        if (!reader.next(record)) break;
+        counters.records++;
+
+        hits.clear();
+        errors.clear();
+        while (next_candidate != plan.candidates.cend() && next_candidate->record < current) ++next_candidate;
+        for (; next_candidate != plan.candidates.cend() && next_candidate->record == current; ++next_candidate) {
+            if (next_candidate->start >= record.sequence.size()) continue;
+            counters.positions++;
+            size_t error(errors_at(record.sequence, patterns[next_candidate->contig].sequence, next_candidate->start, max_errors[next_candidate->contig]));
+            if (error > max_errors[next_candidate->contig]) continue;
+            hits.push_back(*next_candidate);
+            errors.push_back(error);
+        }
+        for (size_t id : plan.fallback) {
+            string_view pattern(patterns[id].sequence);
+            for (size_t start = 0; start < record.sequence.size(); start++) {
+                if (pattern.size() - min(pattern.size(), record.sequence.size() - start) > max_errors[id]) break;
+                size_t error(errors_at(record.sequence, pattern, start, max_errors[id]));
+                counters.positions++;
+                if (error > max_errors[id]) continue;
+                hits.push_back({current, id, start});
+                errors.push_back(error);
+            }
+        }
+
+        vector<size_t> order(hits.size());
+        for (size_t i = 0; i < order.size(); i++) order[i] = i;
+        sort(order.begin(), order.end(), [&hits, &patterns, exact](size_t a, size_t b) -> bool {
+            if (exact) {
+                // Ordre de l'automate de fasta::find_exact : par fin, du plus long au plus court, puis par identifiant
+                // de l'automate (séquences de l'ensemble, puis leurs compléments inverses).
+                const Pattern &first(patterns[hits[a].contig]), &second(patterns[hits[b].contig]);
+                size_t end_a(hits[a].start + first.sequence.size()), end_b(hits[b].start + second.sequence.size());
+                if (end_a != end_b) return end_a < end_b;
+                if (first.sequence.size() != second.sequence.size()) return first.sequence.size() > second.sequence.size();
+                if (first.strand != second.strand) return first.strand == '+';
+                return first.contig < second.contig;
+            }
+            if (hits[a].contig != hits[b].contig) return hits[a].contig < hits[b].contig;
+            return hits[a].start < hits[b].start;
+        });
+        for (size_t i : order) {
+            const Pattern &pattern(patterns[hits[i].contig]);
+            double percentage((((double) errors[i]) / ((double) pattern.sequence.size())) * 100.0);
+            for (size_t n = contigs.names_begin(pattern.contig); n < contigs.names_end(pattern.contig); n++) func(contigs.name(n), record.header, pattern.sequence, percentage, pattern.strand);
+        }
+    }
+}
+
+void kmer_index::find_presence(const Index &index, size_t file, const fs::path &filePath, const fasta::ContigSet &contigs, int maxErrorPercentage, bool both_strands, vector<bool> &found) {
+    Plan plan(make_plan(index, file, contigs, maxErrorPercentage, both_strands));
+    const auto &patterns(plan.patterns);
+    const auto &max_errors(plan.max_errors);
+    found.assign(contigs.size(), false);
+    size_t remaining(contigs.size());
+
+    fasta::Reader reader(filePath);
+    fasta::Record record;
+    auto next_candidate(plan.candidates.cbegin());
+
+    stats::Counters &counters(stats::local());
+    for (uint32_t current : plan.visited) {
+        if (remaining == 0) break;
+        reader.seek(index.record(current).offset);
+        if (!reader.next(record)) break;
+        counters.records++;
+
+        // Un contig déjà trouvé n'est plus vérifié.
+        while (next_candidate != plan.candidates.cend() && next_candidate->record < current) ++next_candidate;
+        for (; next_candidate != plan.candidates.cend() && next_candidate->record == current; ++next_candidate) {
+            size_t contig(patterns[next_candidate->contig].contig);
+            if (found[contig] || next_candidate->start >= record.sequence.size()) continue;
+            counters.positions++;
+            if (errors_at(record.sequence, patterns[next_candidate->contig].sequence, next_candidate->start, max_errors[next_candidate->contig]) > max_errors[next_candidate->contig]) continue;
+            found[contig] = true;
+            remaining--;
+        }
+        for (size_t id : plan.fallback) {
+            size_t contig(patterns[id].contig);
+            string_view pattern(patterns[id].sequence);
+            for (size_t start = 0; !found[contig] && start < record.sequence.size(); start++) {
+                if (pattern.size() - min(pattern.size(), record.sequence.size() - start) > max_errors[id]) break;
+                counters.positions++;
+                if (errors_at(record.sequence, pattern, start, max_errors[id]) > max_errors[id]) continue;
+                found[contig] = true;
+                remaining--;
+            }
+        }
+    }
+}
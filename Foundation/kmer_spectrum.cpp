@@ -0,0 +1,202 @@
+//
+// Created by Florian Claisse on 17/10/2026.
+//
+
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+
+#include "include/kmer_spectrum.h"
+#include "include/codon.h"
+#include "include/fasta_reader.h"
+#include "include/thread_pool.h"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+static const char MAGIC[8] = {'C', 'T', 'G', 'K', 'M', 'C', '1', '\0'};
+
+/** Bases lues avant de répartir le lot entre les workers. */
+static const size_t BATCH_SIZE = 1 << 24;
+/** Bases comptées par tâche. */
+static const size_t CHUNK_SIZE = 1 << 20;
+/** Jusqu'à cette taille, une tâche compte dans un tableau dense avant de reporter ses nombres dans la table. */
+static const unsigned DENSE_K = 8;
+/** Taux de remplissage maximal de la table, en quarts. */
+static const size_t MAX_LOAD = 3;
+
+static inline uint64_t slot_hash(uint64_t key) {
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53ULL;
+    key ^= key >> 33;
+    return key;
+}
+
+kmer_spectrum::Table::Table(size_t capacity): mask(0), used(0) {
+    size_t size(16);
+    while (size < capacity) size <<= 1;
+    keys = make_unique<atomic<uint64_t>[]>(size);
+    counts = make_unique<atomic<uint64_t>[]>(size);
+    mask = size - 1;
+}
+
+void kmer_spectrum::Table::add(uint64_t kmer, uint64_t count) {
+    uint64_t key(kmer + 1);
+    for (size_t i = slot_hash(key) & mask;; i = (i + 1) & mask) {
+        uint64_t current(keys[i].load(memory_order_relaxed));
+        if (current == 0 && keys[i].compare_exchange_strong(current, key, memory_order_relaxed)) {
+            used.fetch_add(1, memory_order_relaxed);
+            current = key;
+        }
+        // Après un échec du compare-and-swap, current est la clé écrite par un autre thread, peut-être la même.
+        if (current == key) {
+            counts[i].fetch_add(count, memory_order_relaxed);
+            return;
+        }
+    }
+}
+
+void kmer_spectrum::Table::reserve(size_t additional) {
+    size_t needed(size() + additional), size(capacity());
+    while (needed * 4 > size * MAX_LOAD) size <<= 1;
+    if (size != capacity()) rehash(size);
+}
+
+void kmer_spectrum::Table::rehash(size_t new_capacity) {
+    unique_ptr<atomic<uint64_t>[]> old_keys(move(keys)), old_counts(move(counts));
+    size_t old_capacity(mask + 1);
+    keys = make_unique<atomic<uint64_t>[]>(new_capacity);
+    counts = make_unique<atomic<uint64_t>[]>(new_capacity);
+    mask = new_capacity - 1;
+
+    for (size_t old = 0; old < old_capacity; old++) {
+        uint64_t key(old_keys[old].load(memory_order_relaxed));
+        if (key == 0) continue;
+        size_t i(slot_hash(key) & mask);
+        while (keys[i].load(memory_order_relaxed) != 0) i = (i + 1) & mask;
+        keys[i].store(key, memory_order_relaxed);
+        counts[i].store(old_counts[old].load(memory_order_relaxed), memory_order_relaxed);
+    }
+}
+
+vector<kmer_spectrum::Entry> kmer_spectrum::Table::sorted(uint64_t min_count) const {
+    vector<Entry> entries;
+    entries.reserve(size());
+    for (size_t i = 0; i <= mask; i++) {
+        uint64_t key(keys[i].load(memory_order_relaxed)), count(counts[i].load(memory_order_relaxed));
+        if (key != 0 && count >= min_count) entries.emplace_back(key - 1, count);
+    }
+    sort(entries.begin(), entries.end());
+    return entries;
+}
+
+/** Compte les k-mers complets de text. Les codes direct et complément inverse sont mis à jour à chaque base. */
+template<bool dense>
+static void count_chunk(string_view text, unsigned k, kmer_spectrum::Table &table) {
+    uint64_t mask((1ULL << (2 * k)) - 1), forward(0), reverse(0);
+    unsigned shift(2 * (k - 1));
+    size_t valid(0);
+    vector<uint64_t> local(dense ? (size_t) 1 << (2 * k) : 0);
+
+    for (const char c : text) {
+        uint8_t code(codon::BASE_CODES[(unsigned char) c]);
+        if (code > 3) {
+            valid = 0;
+            continue;
+        }
+        forward = ((forward << 2) | code) & mask;
+        reverse = (reverse >> 2) | ((uint64_t) (3 - code) << shift);
+        if (++valid < k) continue;
+        if constexpr (dense) local[min(forward, reverse)]++;
+        else table.add(min(forward, reverse));
+    }
+
+    if constexpr (dense) {
+        for (size_t kmer = 0; kmer < local.size(); kmer++) {
+            if (local[kmer] != 0) table.add(kmer, local[kmer]);
+        }
+    }
+}
+
+int kmer_spectrum::count(const fs::path &filePath, unsigned k, Table &table, ThreadPool &pool) {
+    if (k == 0 || k > MAX_K) return EXIT_FAILURE;
+    fasta::Reader reader(filePath);
+    if (!reader.is_open()) return EXIT_FAILURE;
+
+    // Le lot est découpé en morceaux qui se recouvrent de k - 1 bases : chaque k-mer est complet dans un seul morceau.
+    string batch;
+    auto flush = [&]() -> void {
+        if (batch.size() < k) {
+            batch.clear();
+            return;
+        }
+        table.reserve(min<uint64_t>(batch.size(), 1ULL << (2 * k)));
+        for (size_t begin = 0; begin + k <= batch.size(); begin += CHUNK_SIZE) {
+            string_view chunk(string_view(batch).substr(begin, CHUNK_SIZE + k - 1));
+            pool.submit([chunk, k, &table]() -> void {
+                if (k <= DENSE_K) count_chunk<true>(chunk, k, table);
+                else count_chunk<false>(chunk, k, table);
+            });
+        }
+        pool.wait();
+        batch.clear();
+    };
+
+    // Les enregistrements sont mis bout à bout, séparés par un 'N' qu'aucun k-mer ne traverse.
+    fasta::Record record;
+    while (reader.next_window(record, BATCH_SIZE, k - 1)) {
+        string_view sequence(record.sequence);
+        if (record.start != 0 && !batch.empty()) sequence.remove_prefix(min<size_t>(k - 1, sequence.size()));
+        else if (!batch.empty()) batch += 'N';
+        batch += sequence;
+        if (batch.size() >= BATCH_SIZE) flush();
+    }
+    flush();
+    return EXIT_SUCCESS;
+}
+
+string kmer_spectrum::decode(uint64_t kmer, unsigned k) {
+    static const char bases[] = "ACGT";
+    string text(k, 'A');
+    for (unsigned i = 0; i < k; i++) text[k - 1 - i] = bases[(kmer >> (2 * i)) & 3];
+    return text;
+}
+
+int kmer_spectrum::write_tsv(const fs::path &output, const vector<Entry> &entries, unsigned k) {
+    ofstream stream(output, ios::binary | ios::trunc);
+    if (!stream.is_open()) return EXIT_FAILURE;
+
+    string buffer;
+    char number[24];
+    for (const auto &entry : entries) {
+        buffer += decode(entry.first, k);
+        buffer += '\t';
+        buffer.append(number, to_chars(number, number + sizeof(number), entry.second).ptr);
+        buffer += '\n';
+        if (buffer.size() >= (1 << 20)) {
+            stream.write(buffer.data(), (streamsize) buffer.size());
+            buffer.clear();
+        }
+    }
+    stream.write(buffer.data(), (streamsize) buffer.size());
+    return stream.good() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int kmer_spectrum::write_binary(const fs::path &output, const vector<Entry> &entries, unsigned k, uint64_t min_count) {
+    ofstream stream(output, ios::binary | ios::trunc);
+    if (!stream.is_open()) return EXIT_FAILURE;
+
+    Header header{};
+    copy(MAGIC, MAGIC + sizeof(MAGIC), header.magic);
+    header.k = k;
+    header.min_count = (uint32_t) min_count;
+    header.entry_count = entries.size();
+    stream.write((const char*) &header, sizeof(header));
+    for (const auto &entry : entries) {
+        uint64_t pair[2] = {entry.first, entry.second};
+        stream.write((const char*) pair, sizeof(pair));
+    }
+    return stream.good() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
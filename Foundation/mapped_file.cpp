@@ -0,0 +1,33 @@
+//
+// Created by Florian Claisse on 17/10/2026.
+//
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "include/mapped_file.h"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+MappedFile::MappedFile(const fs::path &filePath, bool sequential): bytes(nullptr), length(0), opened(false) {
+    int fd(open(filePath.c_str(), O_RDONLY));
+    if (fd < 0) return;
+
+    off_t end(lseek(fd, 0, SEEK_END));
+    if (end > 0) {
+        void *mapped(mmap(nullptr, (size_t) end, PROT_READ, MAP_PRIVATE, fd, 0));
+        if (mapped != MAP_FAILED) {
+            bytes = (const char*) mapped;
+            length = (size_t) end;
+            if (sequential) madvise(mapped, length, MADV_SEQUENTIAL);
+            opened = true;
+        }
+    } else if (end == 0) opened = true;
+    close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (bytes != nullptr) munmap((void*) bytes, length);
+}
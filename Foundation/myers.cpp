@@ -0,0 +1,114 @@
+//
+// Created by Florian Claisse on 17/10/2026.
+//
+
+#include <algorithm>
+
+#include "include/myers.h"
+
+using namespace std;
+
+myers::Pattern::Pattern(string_view sequence): length(sequence.size()), block_count((sequence.size() + 63) / 64) {
+    masks.assign(256 * block_count, 0);
+    for (size_t i = 0; i < length; i++) masks[(size_t) (unsigned char) sequence[i] * block_count + i / 64] |= 1ULL << (i % 64);
+}
+
+/** État d'un bloc de 64 lignes : différences verticales positives (P) et négatives (M). */
+struct Block {
+    uint64_t P;
+    uint64_t M;
+};
+
+/**
+ * Avance un bloc d'une colonne. hin est la différence horizontale qui entre par la première ligne du bloc,
+ * la valeur renvoyée est celle qui sort par la ligne high (dernière ligne du bloc).
+ */
+static inline int advance_block(Block &block, uint64_t Eq, int hin, uint64_t high) {
+    uint64_t Pv(block.P), Mv(block.M);
+    uint64_t Xv(Eq | Mv);
+    if (hin < 0) Eq |= 1;
+    uint64_t Xh((((Eq & Pv) + Pv) ^ Pv) | Eq);
+    uint64_t Ph(Mv | ~(Xh | Pv));
+    uint64_t Mh(Pv & Xh);
+
+    int hout(0);
+    if (Ph & high) hout = 1;
+    else if (Mh & high) hout = -1;
+
+    Ph <<= 1;
+    Mh <<= 1;
+    if (hin < 0) Mh |= 1;
+    else if (hin > 0) Ph |= 1;
+
+    block.P = Mh | ~(Xv | Ph);
+    block.M = Ph & Xv;
+    return hout;
+}
+
+/**
+ * Calcule la distance de chaque fin de text et appelle on_end(end, distance) pour celles acceptées, tant qu'il
+ * renvoie true. La première ligne de la matrice est nulle (le motif peut commencer n'importe où) : aucune
+ * différence horizontale n'entre dans le premier bloc.
+ */
+template<typename F>
+static void scan(string_view text, const myers::Pattern &pattern, size_t maxDistance, F &&on_end) {
+    size_t m(pattern.size()), blocks(pattern.blocks());
+    if (m == 0) return;
+    uint64_t last_high(1ULL << ((m - 1) % 64));
+    long long score((long long) m), limit((long long) maxDistance);
+
+    if (blocks == 1) {
+        Block block{~0ULL, 0};
+        for (size_t j = 0; j < text.size(); j++) {
+            score += advance_block(block, pattern.peq((unsigned char) text[j])[0], 0, last_high);
+            if (score <= limit && !on_end(j + 1, (size_t) score)) return;
+        }
+        return;
+    }
+
+    vector<Block> state(blocks, Block{~0ULL, 0});
+    for (size_t j = 0; j < text.size(); j++) {
+        const uint64_t *Eq(pattern.peq((unsigned char) text[j]));
+        int carry(0);
+        for (size_t b = 0; b + 1 < blocks; b++) carry = advance_block(state[b], Eq[b], carry, 1ULL << 63);
+        score += advance_block(state[blocks - 1], Eq[blocks - 1], carry, last_high);
+        if (score <= limit && !on_end(j + 1, (size_t) score)) return;
+    }
+}
+
+void myers::search(string_view text, const Pattern &pattern, size_t maxDistance, vector<Hit> &hits) {
+    // Les fins consécutives acceptées sont regroupées, seule la meilleure est gardée.
+    size_t first(hits.size()), previous(0);
+    scan(text, pattern, maxDistance, [&](size_t end, size_t distance) -> bool {
+        if (hits.size() > first && previous + 1 == end) {
+            if (distance < hits.back().distance) hits.back() = {end, distance};
+        }
+        else hits.push_back({end, distance});
+        previous = end;
+        return true;
+    });
+}
+
+size_t myers::find(string_view text, const Pattern &pattern, size_t maxDistance) {
+    size_t first(0);
+    scan(text, pattern, maxDistance, [&first](size_t end, size_t) -> bool {
+        first = end;
+        return false;
+    });
+    return first;
+}
+
+size_t myers::distance_scalar(string_view text, string_view pattern, size_t end) {
+    // Colonne par colonne, la ligne 0 reste nulle.
+    vector<size_t> column(pattern.size() + 1);
+    for (size_t i = 0; i <= pattern.size(); i++) column[i] = i;
+    for (size_t j = 0; j < end; j++) {
+        size_t diagonal(column[0]);
+        for (size_t i = 1; i <= pattern.size(); i++) {
+            size_t current(min({column[i] + 1, column[i - 1] + 1, diagonal + (pattern[i - 1] == text[j] ? 0 : 1)}));
+            diagonal = column[i];
+            column[i] = current;
+        }
+    }
+    return column[pattern.size()];
+}
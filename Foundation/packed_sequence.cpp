@@ -0,0 +1,265 @@
+//
+// Created by Florian Claisse on 17/10/2026.
+//
+
+#include <algorithm>
+#include <array>
+
+#include "include/packed_sequence.h"
+
+using namespace std;
+
+static constexpr uint8_t EXCEPTION(4);
+
+/** Table de codage octet -> code 2 bits, EXCEPTION pour tout ce qui n'est pas A/C/G/T. */
+static constexpr array<uint8_t, 256> make_codes() {
+    array<uint8_t, 256> codes{};
+    for (auto &code : codes) code = EXCEPTION;
+    codes['A'] = 0; codes['C'] = 1; codes['G'] = 2; codes['T'] = 3;
+    codes['a'] = 0; codes['c'] = 1; codes['g'] = 2; codes['t'] = 3;
+    return codes;
+}
+static constexpr array<uint8_t, 256> CODES(make_codes());
+
+/** Écarte les 32 bits de value sur les bits pairs d'un mot de 64 bits (un bit par base codée sur 2 bits). */
+static inline uint64_t spread(uint32_t value) {
+    uint64_t x(value);
+    x = (x | (x << 16)) & 0x0000FFFF0000FFFFULL;
+    x = (x | (x << 8)) & 0x00FF00FF00FF00FFULL;
+    x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    x = (x | (x << 2)) & 0x3333333333333333ULL;
+    x = (x | (x << 1)) & 0x5555555555555555ULL;
+    return x;
+}
+
+void packed::Sequence::append(string_view text) {
+    // Un mot nul est toujours gardé après le dernier mot utilisé, les lectures de 32 bases n'ont pas à tester la fin.
+    // Appelé ligne par ligne par Reader::next : la réserve double pour ne pas recopier les mots à chaque ligne.
+    size_t needed((count + text.size()) / 32 + 2);
+    if (needed > words.capacity()) words.reserve(max(needed, 2 * words.capacity()));
+    for (const char c : text) {
+        if (count % 32 == 0) words.resize(count / 32 + 2, 0);
+        if (!mask.empty() && count % 64 == 0) mask.push_back(0);
+
+        uint8_t code(CODES[(unsigned char) c]);
+        if (code != EXCEPTION) words[count / 32] |= (uint64_t) code << (2 * (count % 32));
+        else {
+            if (mask.empty()) mask.assign(count / 64 + 1, 0);
+            mask[count / 64] |= 1ULL << (count % 64);
+
+            char symbol((c >= 'a' && c <= 'z') ? (char) (c - 'a' + 'A') : c);
+            if (!runs.empty() && runs.back().symbol == symbol && runs.back().start + runs.back().length == count) runs.back().length++;
+            else runs.push_back({count, 1, symbol});
+        }
+        count++;
+    }
+}
+
+void packed::Sequence::clear() {
+    words.clear();
+    mask.clear();
+    runs.clear();
+    count = 0;
+}
+
+char packed::Sequence::at(size_t position) const {
+    if (!mask.empty() && (mask[position / 64] >> (position % 64)) & 1) {
+        auto run(upper_bound(runs.begin(), runs.end(), position, [](size_t value, const Run &current) -> bool { return value < current.start; }));
+        return prev(run)->symbol;
+    }
+    return "ACGT"[(words[position / 32] >> (2 * (position % 32))) & 3];
+}
+
+string packed::Sequence::unpack() const {
+    string result(count, 'N');
+    for (size_t i = 0; i < count; i++) result[i] = at(i);
+    return result;
+}
+
+void packed::Sequence::unpack(size_t begin, size_t size, string &text) const {
+    begin = min(begin, count);
+    size = min(size, count - begin);
+    text.resize(size);
+    for (size_t i = 0, position = begin; i < size;) {
+        // Un mot est chargé une fois pour ses 32 bases.
+        uint64_t word(words[position / 32] >> (2 * (position % 32)));
+        for (size_t n = min(size - i, 32 - position % 32); n > 0; n--, i++, position++, word >>= 2) text[i] = "ACGT"[word & 3];
+    }
+
+    // Les suites d'exceptions qui recouvrent l'intervalle remplacent les bases codées 0.
+    auto run(upper_bound(runs.begin(), runs.end(), begin, [](size_t value, const Run &current) -> bool { return value < current.start; }));
+    if (run != runs.begin()) --run;
+    for (; run != runs.end() && run->start < begin + size; ++run) {
+        size_t from(max(run->start, begin)), to(min(run->start + run->length, begin + size));
+        for (size_t position = from; position < to; position++) text[position - begin] = run->symbol;
+    }
+}
+
+uint64_t packed::Sequence::bases_at(size_t position) const {
+    size_t index(position / 32), shift(2 * (position % 32));
+    if (index >= words.size()) return 0;
+    uint64_t result(words[index] >> shift);
+    if (shift != 0 && index + 1 < words.size()) result |= words[index + 1] << (64 - shift);
+    return result;
+}
+
+uint32_t packed::Sequence::mask_at(size_t position) const {
+    size_t index(position / 64), shift(position % 64);
+    if (index >= mask.size()) return 0;
+    uint64_t result(mask[index] >> shift);
+    if (shift != 0 && index + 1 < mask.size()) result |= mask[index + 1] << (64 - shift);
+    return (uint32_t) result;
+}
+
+/** Cas courant sans exception : les mots du motif sont alignés, ceux du texte sont recomposés à partir de deux mots. */
+__attribute__((always_inline))
+static inline size_t plain_mismatches(const uint64_t *text_words, size_t offset, const uint64_t *pattern_words, size_t size, size_t budget) {
+    size_t shift(2 * (offset % 32)), index(offset / 32), error(0);
+    for (size_t i = 0; i < size; i += 32, index++) {
+        // Double décalage pour rester défini quand shift vaut 0.
+        uint64_t chunk((text_words[index] >> shift) | ((text_words[index + 1] << 1) << (63 - shift)));
+        uint64_t x(chunk ^ pattern_words[i / 32]);
+        uint64_t different((x | (x >> 1)) & 0x5555555555555555ULL);
+        if (size - i < 32) different &= (1ULL << (2 * (size - i))) - 1;
+        error += (size_t) __builtin_popcountll(different);
+        if (error > budget) return error;
+    }
+    return error;
+}
+
+/**
+ * Cas général : les bases marquées dans les masques sont comparées par symbole. Avec text_exceptions faux, l'appelant
+ * sait qu'aucune exception du texte ne tombe dans [offset, offset + size) et son masque n'est pas lu.
+ */
+__attribute__((always_inline))
+static inline size_t any_mismatches(const packed::Sequence &text, size_t offset, const packed::Sequence &pattern, size_t size, size_t budget, bool text_exceptions) {
+    bool pattern_exceptions(pattern.has_exceptions());
+    if (!text_exceptions && !pattern_exceptions) return plain_mismatches(text.word_data(), offset, pattern.word_data(), size, budget);
+
+    // Les mots sont lus comme dans plain_mismatches, les masques seulement pour la séquence qui en a un.
+    const uint64_t *text_words(text.word_data()), *pattern_words(pattern.word_data());
+    size_t shift(2 * (offset % 32)), index(offset / 32), error(0);
+    for (size_t i = 0; i < size; i += 32, index++) {
+        size_t n(min<size_t>(32, size - i));
+        uint64_t chunk((text_words[index] >> shift) | ((text_words[index + 1] << 1) << (63 - shift)));
+        uint64_t x(chunk ^ pattern_words[i / 32]);
+        uint64_t different((x | (x >> 1)) & 0x5555555555555555ULL);
+        if (n < 32) different &= (1ULL << (2 * n)) - 1;
+
+        {
+            uint32_t limit(n < 32 ? (1U << n) - 1 : 0xFFFFFFFFU);
+            uint32_t text_mask(text_exceptions ? text.mask_at(offset + i) & limit : 0);
+            uint32_t pattern_mask(pattern_exceptions ? pattern.mask_at(i) & limit : 0);
+            if ((text_mask | pattern_mask) != 0) {
+                // Une exception face à une base A/C/G/T est toujours une différence, deux exceptions se comparent par symbole.
+                different &= ~spread(text_mask | pattern_mask);
+                error += (size_t) __builtin_popcount(text_mask ^ pattern_mask);
+                for (uint32_t both = text_mask & pattern_mask; both != 0; both &= both - 1) {
+                    size_t b((size_t) __builtin_ctz(both));
+                    error += (text.at(offset + i + b) != pattern.at(i + b));
+                }
+            }
+        }
+
+        error += (size_t) __builtin_popcountll(different);
+        if (error > budget) return error;
+    }
+    return error;
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+__attribute__((target("popcnt")))
+static size_t mismatches_popcnt(const packed::Sequence &text, size_t offset, const packed::Sequence &pattern, size_t size, size_t budget) {
+    return any_mismatches(text, offset, pattern, size, budget, text.has_exceptions());
+}
+
+static bool has_popcnt() {
+    static const bool popcnt([]() {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("popcnt") != 0;
+    }());
+    return popcnt;
+}
+#endif
+
+size_t packed::mismatches(const Sequence &text, size_t offset, const Sequence &pattern, size_t size, size_t budget) {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    if (has_popcnt()) return mismatches_popcnt(text, offset, pattern, size, budget);
+#endif
+    return any_mismatches(text, offset, pattern, size, budget, text.has_exceptions());
+}
+
+bool packed::equal(const Sequence &text, size_t offset, const Sequence &pattern) {
+    if (offset + pattern.size() > text.size()) return false;
+    return mismatches(text, offset, pattern, pattern.size(), 0) == 0;
+}
+
+/** Parcourt les positions de text par ordre croissant et appelle on_hit(offset, error) pour chacune, tant qu'il renvoie true. */
+template<typename F>
+__attribute__((always_inline))
+static inline void scan_positions(const packed::Sequence &text, const packed::Sequence &pattern, size_t maxError, size_t begin, size_t end, F &&on_hit) {
+    size_t text_size(text.size()), pattern_size(pattern.size());
+    // Seules les positions dont la fenêtre recouvre une suite d'exceptions du texte passent par le cas général.
+    const vector<packed::Run> &runs(text.exception_runs());
+    auto run(partition_point(runs.begin(), runs.end(), [begin](const packed::Run &current) -> bool { return current.start + current.length <= begin; }));
+    for (size_t i = begin; i < min(end, text_size); i++) {
+        size_t overlap(min(pattern_size, text_size - i));
+        size_t error(pattern_size - overlap);
+        if (error > maxError) break;
+        while (run != runs.end() && run->start + run->length <= i) ++run;
+        error += any_mismatches(text, i, pattern, overlap, maxError - error, run != runs.end() && run->start < i + overlap);
+        if (error <= maxError && !on_hit(i, error)) return;
+    }
+}
+
+__attribute__((always_inline))
+static inline void scan_all(const packed::Sequence &text, const packed::Sequence &pattern, size_t maxError, size_t begin, size_t end, vector<packed::Hit> &hits) {
+    scan_positions(text, pattern, maxError, begin, end, [&hits](size_t offset, size_t error) -> bool {
+        hits.push_back({offset, error});
+        return true;
+    });
+}
+
+__attribute__((always_inline))
+static inline size_t scan_first(const packed::Sequence &text, const packed::Sequence &pattern, size_t maxError) {
+    size_t first(text.size());
+    scan_positions(text, pattern, maxError, 0, text.size(), [&first](size_t offset, size_t) -> bool {
+        first = offset;
+        return false;
+    });
+    return first;
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+__attribute__((target("popcnt")))
+static void scan_popcnt(const packed::Sequence &text, const packed::Sequence &pattern, size_t maxError, size_t begin, size_t end, vector<packed::Hit> &hits) {
+    scan_all(text, pattern, maxError, begin, end, hits);
+}
+
+__attribute__((target("popcnt")))
+static size_t find_popcnt(const packed::Sequence &text, const packed::Sequence &pattern, size_t maxError) {
+    return scan_first(text, pattern, maxError);
+}
+
+#endif
+
+void packed::scan(const Sequence &text, const Sequence &pattern, size_t maxError, vector<Hit> &hits) {
+    scan(text, pattern, maxError, 0, text.size(), hits);
+}
+
+void packed::scan(const Sequence &text, const Sequence &pattern, size_t maxError, size_t begin, size_t end, vector<Hit> &hits) {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    if (has_popcnt()) {
+        scan_popcnt(text, pattern, maxError, begin, end, hits);
+        return;
+    }
+#endif
+    scan_all(text, pattern, maxError, begin, end, hits);
+}
+
+size_t packed::find(const Sequence &text, const Sequence &pattern, size_t maxError) {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    if (has_popcnt()) return find_popcnt(text, pattern, maxError);
+#endif
+    return scan_first(text, pattern, maxError);
+}
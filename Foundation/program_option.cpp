@@ -6,8 +6,12 @@
 #include <charconv>
 
 #include "include/program_option.h"
+#include "include/sequence_file.h"
 #include "../FindAll/find_all.h"
 #include "../CodonCount/condo_count.h"
+#include "../BuildIndex/build_index.h"
+#include "../KmerCount/kmer_count.h"
+#include "../Convert/convert.h"
 
 using namespace std;
 namespace fs = std::filesystem;
@@ -25,6 +29,12 @@ int program_option::parse(int argc, char **argv) {
         return parse_find_all(sub_args);
     } else if (args[1] == CODONCOUNT) {
         return parse_codon_count(sub_args);
+    } else if (args[1] == BUILDINDEX) {
+        return parse_build_index(sub_args);
+    } else if (args[1] == KMERCOUNT) {
+        return parse_kmer_count(sub_args);
+    } else if (args[1] == CONVERT) {
+        return parse_convert(sub_args);
     }
 
     return usage();
@@ -35,61 +45,117 @@ int program_option::usage() {
     << "./Contig [program_name] ..." << endl
     << "\t" << FINDALL << "\tProgramme qui permet à partir d'un fichier A (type nucl ou prot), de trouver si il sont présent dans tous les fichiers du dossier B."
     << "\t" << CODONCOUNT << "\tProgramme qui permet à partir d'un fichier d'entrée A de compter le nombre de chaque codon pour chaque contig."
+    << "\t" << BUILDINDEX << "\tProgramme qui construit un index des k-mers d'un dossier B, réutilisable par " << FINDALL << "."
+    << "\t" << KMERCOUNT << "\tProgramme qui compte les k-mers canoniques des fichiers d'un dossier B (spectre de k-mers)."
+    << "\t" << CONVERT << "\tProgramme qui convertit les fichiers fasta d'un dossier B en conteneurs binaires indexés (." << fasta::SEQUENCE_FILE_EXTENSION << ")."
     << endl;
 
     return EXIT_SUCCESS;
 }
 
-// --inputA <path> --inputB <path> --type <nucl/prot> [--output <path>] [--accept <percentage>]
+// --inputA <path> --inputB <path> --type <nucl/prot> [--output <path>] [--accept <percentage>] [--threads <count>] [--index <path>] [--strand <forward/both>] [--stats <path>] [--presence <path>] [--indels <off/on>] [--max-memory <MiB>] [--cache <path>] [--translate <off/on>] [--serve <-/path>] [--best <count>]
 int program_option::parse_find_all(const vector<string_view> &argv) {
     if (argv.size() < 6 || (argv.size() % 2) != 0) return find_all_usage();
-    if (argv[0] != INPUTA || argv[2] != INPUTB) return find_all_usage();
-
-    bool output(false), accept(false);
-    string outputPath(argv[3]);
-    int acceptValue(100);
-    cout << __LINE__ << endl;
-    if (argv.size() >= 8) {
-        if (argv[6] == OUTPUT) {
-            output = true;
-            outputPath = string(argv[7]);
-        }
-        else if (argv[6] == ACCEPT) {
-            accept = true;
-            auto result = from_chars(argv[7].data(), argv[7].data() + argv[7].size(), acceptValue);
+
+    string inputA, inputB, type, outputPath, indexPath, statsPath, presencePath, cachePath, servePath, strand(FORWARD), indels(OFF), translate(OFF);
+    int acceptValue(100), threadsValue(1), memoryValue(0), bestValue(0);
+    for (size_t i = 0; i < argv.size(); i += 2) {
+        const string_view &option(argv[i]), &value(argv[i + 1]);
+        if (option == INPUTA && inputA.empty()) inputA = string(value);
+        else if (option == INPUTB && inputB.empty()) inputB = string(value);
+        else if (option == TYPE && type.empty()) type = string(value);
+        else if (option == OUTPUT && outputPath.empty()) outputPath = string(value);
+        else if (option == ACCEPT) {
+            auto result = from_chars(value.data(), value.data() + value.size(), acceptValue);
             if (result.ec == errc::invalid_argument) return find_all_usage();
         }
-        else return find_all_usage();
-        cout << __LINE__ << endl;
-    }
-    if (argv.size() == 10) {
-        cout << __LINE__ << endl;
-        if (argv[8] == OUTPUT && !output) {
-            outputPath = string(argv[9]);
+        else if (option == INDEX && indexPath.empty()) indexPath = string(value);
+        else if (option == STRAND) strand = string(value);
+        else if (option == STATS && statsPath.empty()) statsPath = string(value);
+        else if (option == PRESENCE && presencePath.empty()) presencePath = string(value);
+        else if (option == INDELS) indels = string(value);
+        else if (option == CACHE && cachePath.empty()) cachePath = string(value);
+        else if (option == TRANSLATE) translate = string(value);
+        else if (option == SERVE && servePath.empty()) servePath = string(value);
+        else if (option == MAXMEMORY) {
+            auto result = from_chars(value.data(), value.data() + value.size(), memoryValue);
+            if (result.ec == errc::invalid_argument || memoryValue < 1) return find_all_usage();
         }
-        else if (argv[8] == ACCEPT && !accept) {
-            auto result = from_chars(argv[9].data(), argv[9].data() + argv[9].size(), acceptValue);
-            if (result.ec == errc::invalid_argument) return find_all_usage();
+        else if (option == THREADS) {
+            auto result = from_chars(value.data(), value.data() + value.size(), threadsValue);
+            if (result.ec == errc::invalid_argument || threadsValue < 1) return find_all_usage();
+        }
+        else if (option == BEST) {
+            auto result = from_chars(value.data(), value.data() + value.size(), bestValue);
+            if (result.ec == errc::invalid_argument || bestValue < 1) return find_all_usage();
         }
         else return find_all_usage();
-        cout << __LINE__ << endl;
     }
-    if (argv.size() > 10) return find_all_usage();
-    cout << __LINE__ << endl;
-    if (!fs::exists(argv[1])) {
+    // En mode serveur, le dossier B est donné par chaque recherche.
+    if (inputA.empty() || (inputB.empty() && servePath.empty()) || type.empty()) return find_all_usage();
+    // Les résultats d'un seul fichier fasta sont écrits à côté de lui.
+    if (outputPath.empty() && !inputB.empty()) outputPath = fs::is_directory(inputB) ? inputB : fs::absolute(inputB).parent_path().string();
+
+    if (!fs::exists(inputA)) {
         cout << "Le fichier d'entrée A n'existe pas ou n'est pas accessible." << endl;
         return EXIT_FAILURE;
     }
-    if (!fs::exists(argv[3])) {
+    if (!inputB.empty() && !fs::exists(inputB)) {
         cout << "Le dossier d'entrée B n'exsite pas ou n'est pas accessible." << endl;
         return EXIT_FAILURE;
     }
-    if (string(argv[5]) != NUCLEIC && string(argv[5]) != PROTEIN) {
+    if (type != NUCLEIC && type != PROTEIN) {
         cout << "Le type de fichier n'est pas valide." << endl;
         return EXIT_FAILURE;
     }
 
-    FindAll options = {string(argv[1]), string(argv[3]), outputPath, acceptValue, string(argv[5]) == NUCLEIC};
+    if (strand != FORWARD && strand != BOTH) {
+        cout << "Le brin doit être " << FORWARD << " ou " << BOTH << "." << endl;
+        return EXIT_FAILURE;
+    }
+    if (strand == BOTH && type != NUCLEIC) {
+        cout << "La recherche sur les deux brins n'est possible qu'avec le type " << NUCLEIC << "." << endl;
+        return EXIT_FAILURE;
+    }
+    if (indels != OFF && indels != ON) {
+        cout << "L'option " << INDELS << " doit être " << OFF << " ou " << ON << "." << endl;
+        return EXIT_FAILURE;
+    }
+    if (indels == ON && !indexPath.empty()) {
+        cout << "La recherche avec " << INDELS << " " << ON << " ne peut pas utiliser d'index." << endl;
+        return EXIT_FAILURE;
+    }
+    if (translate != OFF && translate != ON) {
+        cout << "L'option " << TRANSLATE << " doit être " << OFF << " ou " << ON << "." << endl;
+        return EXIT_FAILURE;
+    }
+    if (translate == ON && type != PROTEIN) {
+        cout << "La recherche traduite n'est possible qu'avec le type " << PROTEIN << "." << endl;
+        return EXIT_FAILURE;
+    }
+    if (translate == ON && (indels == ON || !indexPath.empty() || !presencePath.empty())) {
+        cout << "La recherche traduite ne peut pas être combinée avec " << INDELS << " " << ON << ", " << INDEX << " ou " << PRESENCE << "." << endl;
+        return EXIT_FAILURE;
+    }
+    if (bestValue != 0 && acceptValue == 100) {
+        cout << "L'option " << BEST << " n'a de sens qu'avec " << ACCEPT << " inférieur à 100." << endl;
+        return EXIT_FAILURE;
+    }
+    if (bestValue != 0 && (indels == ON || !indexPath.empty() || translate == ON || !presencePath.empty())) {
+        cout << "L'option " << BEST << " ne peut pas être combinée avec " << INDELS << " " << ON << ", " << INDEX << ", " << TRANSLATE << " " << ON << " ou " << PRESENCE << "." << endl;
+        return EXIT_FAILURE;
+    }
+    // Seules les recherches qui lisent les enregistrements par fenêtres respectent la limite.
+    if (memoryValue != 0 && (!indexPath.empty() || translate == ON || (acceptValue != 100 && (indels == ON || !presencePath.empty())))) {
+        cout << "L'option " << MAXMEMORY << " ne peut pas être combinée avec " << INDEX << " ou " << TRANSLATE << " " << ON << ", ni avec " << INDELS << " " << ON << " ou " << PRESENCE << " quand " << ACCEPT << " est inférieur à 100 : ces recherches lisent les enregistrements en entier." << endl;
+        return EXIT_FAILURE;
+    }
+    if (!indexPath.empty() && !fs::exists(indexPath)) {
+        cout << "L'index n'existe pas ou n'est pas accessible." << endl;
+        return EXIT_FAILURE;
+    }
+
+    FindAll options = {inputA, inputB, outputPath, acceptValue, type == NUCLEIC, (unsigned) threadsValue, indexPath, strand == BOTH, statsPath, presencePath, indels == ON, (size_t) memoryValue << 20, cachePath, translate == ON, servePath, (size_t) bestValue};
     return find_all::start(options);
 }
 
@@ -101,7 +167,18 @@ int program_option::find_all_usage() {
     << "\t" << INPUTB << "\tChemin vers le dossier qui contient les fichiers ou il faut trouver les contigs." << endl
     << "\t" << TYPE << "\tLe type de fichier (nucl/prot)." << endl
     << "\t" << OUTPUT << "\tChemin vers le dossier qui va contenir le/les fichier(s) de sortie." << endl
-    << "\t" << ACCEPT << "\tPermet de spécifier le pourcentage minimum pour accepter un contig comme reconnu." << endl;
+    << "\t" << ACCEPT << "\tPermet de spécifier le pourcentage minimum pour accepter un contig comme reconnu." << endl
+    << "\t" << THREADS << "\tNombre de threads (1 par défaut) : les fichiers du dossier B sont traités en parallèle. Si un fichier dépasse la part d'un thread, les fichiers sont traités l'un après l'autre et chaque enregistrement d'au moins 8 Mio est découpé en morceaux cherchés par tous les threads (sans " << INDEX << ", " << PRESENCE << ", " << TRANSLATE << " " << ON << ", " << BEST << " ni " << INDELS << " " << ON << " avec " << ACCEPT << " inférieur à 100)." << endl
+    << "\t" << INDEX << "\tChemin vers un index construit par " << BUILDINDEX << " sur le dossier B (type nucl uniquement)." << endl
+    << "\t" << STRAND << "\tBrin(s) cherché(s) en type nucl : " << FORWARD << " (par défaut) ou " << BOTH << " pour chercher aussi le complément inverse des contigs." << endl
+    << "\t" << STATS << "\tChemin d'un rapport JSON avec la durée de chaque phase et les compteurs de chaque fichier." << endl
+    << "\t" << PRESENCE << "\tChemin d'une matrice TSV contigs x fichiers (1 si présent, 0 sinon), à la place des fichiers de résultats." << endl
+    << "\t" << INDELS << "\tAvec " << ON << ", " << ACCEPT << " compte aussi les insertions et délétions (distance d'édition) et la fin de chaque occurrence est indiquée (" << OFF << " par défaut)." << endl
+    << "\t" << MAXMEMORY << "\tMémoire en Mio des tampons de séquence du dossier B, partagée entre les threads : les enregistrements sont lus par fenêtres (sans limite par défaut). Les contigs, l'automate, le filtre et les occurrences trouvées n'en font pas partie. Incompatible avec " << INDEX << ", " << TRANSLATE << " " << ON << ", et avec " << INDELS << " " << ON << " ou " << PRESENCE << " quand " << ACCEPT << " est inférieur à 100." << endl
+    << "\t" << CACHE << "\tDossier d'un cache des résultats par fichier : les fichiers du dossier B inchangés depuis une recherche identique ne sont pas recherchés de nouveau." << endl
+    << "\t" << TRANSLATE << "\tAvec " << ON << " (type " << PROTEIN << "), les contigs sont cherchés dans les six cadres de lecture des séquences nucléiques du dossier B (" << OFF << " par défaut)." << endl
+    << "\t" << SERVE << "\tMode serveur : le fichier A est préparé une fois, puis chaque ligne lue sur l'entrée standard (" << STDIN << ") ou la socket Unix donnée est une recherche (" << INPUTB << ", " << OUTPUT << ", " << PRESENCE << ", " << STATS << ")." << endl
+    << "\t" << BEST << "\tAvec " << ACCEPT << " inférieur à 100, ne garde que les N occurrences de chaque contig ayant le moins de différences dans chaque fichier (toutes par défaut)." << endl;
     return EXIT_SUCCESS;
 }
 
@@ -116,7 +193,7 @@ int program_option::parse_codon_count(const vector<string_view> &argv) {
         return EXIT_FAILURE;
     }
     if (!fs::exists(argv[3])) {
-        cout << "Le dossier d'entrée B n'exsite pas ou n'est pas accessible." << endl;
+        cout << "Le dossier de sortie n'exsite pas ou n'est pas accessible." << endl;
         return EXIT_FAILURE;
     }
 
@@ -125,6 +202,147 @@ int program_option::parse_codon_count(const vector<string_view> &argv) {
 }
 
 int program_option::codon_count_usage() {
+    cout << "Codon Count" << endl
+    << "Usage :" << endl
+    << "\t" << INPUTA << "\tChemin vers le fichier fasta dont il faut compter les codons." << endl
+    << "\t" << OUTPUT << "\tChemin vers le dossier qui va contenir le fichier de sortie <filename>-codon.tsv." << endl;
+    return EXIT_SUCCESS;
+}
+
+
+
+// --inputB <path> --output <path> [--kmer <k>] [--step <step>]
+int program_option::parse_build_index(const vector<string_view> &argv) {
+    if (argv.size() < 4 || (argv.size() % 2) != 0) return build_index_usage();
+
+    string inputB, outputPath;
+    int kValue(15), stepValue(1);
+    for (size_t i = 0; i < argv.size(); i += 2) {
+        const string_view &option(argv[i]), &value(argv[i + 1]);
+        if (option == INPUTB && inputB.empty()) inputB = string(value);
+        else if (option == OUTPUT && outputPath.empty()) outputPath = string(value);
+        else if (option == KMER) {
+            auto result = from_chars(value.data(), value.data() + value.size(), kValue);
+            if (result.ec == errc::invalid_argument || kValue < 1 || kValue > 32) return build_index_usage();
+        }
+        else if (option == STEP) {
+            auto result = from_chars(value.data(), value.data() + value.size(), stepValue);
+            if (result.ec == errc::invalid_argument || stepValue < 1) return build_index_usage();
+        }
+        else return build_index_usage();
+    }
+    if (inputB.empty() || outputPath.empty()) return build_index_usage();
+
+    if (!fs::exists(inputB)) {
+        cout << "Le dossier d'entrée B n'exsite pas ou n'est pas accessible." << endl;
+        return EXIT_FAILURE;
+    }
+
+    BuildIndex options = {inputB, outputPath, (unsigned) kValue, (unsigned) stepValue};
+    return build_index::start(options);
+}
+
+// --inputB <path> --output <path> [--kmer <k>] [--min-count <count>] [--threads <count>] [--format <tsv/bin>] [--per-file <off/on>]
+int program_option::parse_kmer_count(const vector<string_view> &argv) {
+    if (argv.size() < 4 || (argv.size() % 2) != 0) return kmer_count_usage();
+
+    string inputB, outputPath, format(TSV), perFile(OFF);
+    int kValue(21), threadsValue(1);
+    uint64_t minCount(1);
+    for (size_t i = 0; i < argv.size(); i += 2) {
+        const string_view &option(argv[i]), &value(argv[i + 1]);
+        if (option == INPUTB && inputB.empty()) inputB = string(value);
+        else if (option == OUTPUT && outputPath.empty()) outputPath = string(value);
+        else if (option == KMER) {
+            auto result = from_chars(value.data(), value.data() + value.size(), kValue);
+            if (result.ec == errc::invalid_argument || kValue < 1 || kValue > 31) return kmer_count_usage();
+        }
+        else if (option == MINCOUNT) {
+            auto result = from_chars(value.data(), value.data() + value.size(), minCount);
+            if (result.ec == errc::invalid_argument || minCount < 1 || minCount > UINT32_MAX) return kmer_count_usage();
+        }
+        else if (option == THREADS) {
+            auto result = from_chars(value.data(), value.data() + value.size(), threadsValue);
+            if (result.ec == errc::invalid_argument || threadsValue < 1) return kmer_count_usage();
+        }
+        else if (option == FORMAT) format = string(value);
+        else if (option == PERFILE) perFile = string(value);
+        else return kmer_count_usage();
+    }
+    if (inputB.empty() || outputPath.empty()) return kmer_count_usage();
+
+    if (!fs::exists(inputB)) {
+        cout << "Le dossier d'entrée B n'exsite pas ou n'est pas accessible." << endl;
+        return EXIT_FAILURE;
+    }
+    if (format != TSV && format != BINARY) {
+        cout << "Le format doit être " << TSV << " ou " << BINARY << "." << endl;
+        return EXIT_FAILURE;
+    }
+    if (perFile != OFF && perFile != ON) {
+        cout << "L'option " << PERFILE << " doit être " << OFF << " ou " << ON << "." << endl;
+        return EXIT_FAILURE;
+    }
+
+    KmerCount options = {inputB, outputPath, (unsigned) kValue, minCount, (unsigned) threadsValue, format == BINARY, perFile == ON};
+    return kmer_count::start(options);
+}
+
+// --inputB <path> --output <path> [--packed <off/on>]
+int program_option::parse_convert(const vector<string_view> &argv) {
+    if (argv.size() < 4 || (argv.size() % 2) != 0) return convert_usage();
+
+    string inputB, outputPath, packed(OFF);
+    for (size_t i = 0; i < argv.size(); i += 2) {
+        const string_view &option(argv[i]), &value(argv[i + 1]);
+        if (option == INPUTB && inputB.empty()) inputB = string(value);
+        else if (option == OUTPUT && outputPath.empty()) outputPath = string(value);
+        else if (option == PACKED) packed = string(value);
+        else return convert_usage();
+    }
+    if (inputB.empty() || outputPath.empty()) return convert_usage();
+
+    if (!fs::exists(inputB)) {
+        cout << "Le dossier d'entrée B n'exsite pas ou n'est pas accessible." << endl;
+        return EXIT_FAILURE;
+    }
+    if (packed != OFF && packed != ON) {
+        cout << "L'option " << PACKED << " doit être " << OFF << " ou " << ON << "." << endl;
+        return EXIT_FAILURE;
+    }
+
+    Convert options = {inputB, outputPath, packed == ON};
+    return convert::start(options);
+}
+
+int program_option::build_index_usage() {
+    cout << "Build Index" << endl
+    << "Usage :" << endl
+    << "\t" << INPUTB << "\tChemin vers le dossier qui contient les fichiers à indexer." << endl
+    << "\t" << OUTPUT << "\tChemin du fichier d'index à écrire." << endl
+    << "\t" << KMER << "\tTaille des k-mers indexés, de 1 à 32 (15 par défaut)." << endl
+    << "\t" << STEP << "\tN'indexe qu'une position sur step pour réduire la taille de l'index (1 par défaut)." << endl;
+    return EXIT_SUCCESS;
+}
+
+int program_option::kmer_count_usage() {
+    cout << "Kmer Count" << endl
+    << "Usage :" << endl
+    << "\t" << INPUTB << "\tChemin vers le dossier (ou le fichier fasta) dont les k-mers sont comptés." << endl
+    << "\t" << OUTPUT << "\tChemin vers le dossier qui va contenir le/les spectre(s) (kmers.tsv ou kmers.bin)." << endl
+    << "\t" << KMER << "\tTaille des k-mers, de 1 à 31 (21 par défaut)." << endl
+    << "\t" << MINCOUNT << "\tNombre minimal d'occurrences d'un k-mer pour qu'il soit écrit (1 par défaut)." << endl
+    << "\t" << THREADS << "\tNombre de threads qui se partagent le comptage (1 par défaut)." << endl
+    << "\t" << FORMAT << "\tFormat des spectres : " << TSV << " (par défaut) ou " << BINARY << "." << endl
+    << "\t" << PERFILE << "\tAvec " << ON << ", un spectre <filename>-kmers est aussi écrit pour chaque fichier (" << OFF << " par défaut)." << endl;
     return EXIT_SUCCESS;
 }
 
+int program_option::convert_usage() {
+    cout << "Convert" << endl
+    << "Usage :" << endl
+    << "\t" << INPUTB << "\tChemin vers le dossier (ou le fichier fasta) à convertir." << endl
+    << "\t" << OUTPUT << "\tChemin vers le dossier qui va contenir les conteneurs <filename>." << fasta::SEQUENCE_FILE_EXTENSION << "." << endl
+    << "\t" << PACKED << "\tAvec " << ON << ", les séquences nucléiques sans base ambiguë sont codées sur 2 bits (" << OFF << " par défaut)." << endl;
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,106 @@
+//
+// Created by Florian Claisse on 17/10/2026.
+//
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include "include/result_cache.h"
+#include "include/mapped_file.h"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+ResultCache::ResultCache(fs::path directory, string search): directory(move(directory)), search(move(search)) {
+    error_code error;
+    fs::create_directories(this->directory, error);
+}
+
+static inline uint64_t rotate(uint64_t value, int shift) {
+    return (value << shift) | (value >> (64 - shift));
+}
+
+static inline uint64_t mix(uint64_t value) {
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdULL;
+    value ^= value >> 33;
+    value *= 0xc4ceb9fe1a85ec53ULL;
+    value ^= value >> 33;
+    return value;
+}
+
+string ResultCache::fingerprint(string_view data) {
+    // Deux empreintes de 64 bits sur des multiplicateurs différents, mot de 8 octets par mot de 8 octets.
+    const uint64_t first_prime(0x87c37b91114253d5ULL), second_prime(0x4cf5ad432745937fULL);
+    uint64_t first(0x9e3779b97f4a7c15ULL ^ data.size()), second(0x6a09e667f3bcc909ULL);
+    size_t i(0);
+    for (; i + 8 <= data.size(); i += 8) {
+        uint64_t word;
+        memcpy(&word, data.data() + i, 8);
+        first = rotate(first ^ (word * first_prime), 31) * second_prime + second;
+        second = rotate(second ^ (word * second_prime), 33) * first_prime + first;
+    }
+    uint64_t tail(0);
+    if (i < data.size()) memcpy(&tail, data.data() + i, data.size() - i);
+    first = mix(first ^ (tail * first_prime) ^ data.size());
+    second = mix(second ^ (tail * second_prime) ^ first);
+
+    char hex[33];
+    snprintf(hex, sizeof(hex), "%016llx%016llx", (unsigned long long) first, (unsigned long long) second);
+    return hex;
+}
+
+string ResultCache::file_fingerprint(const fs::path &filePath) {
+    MappedFile file(filePath, true);
+    if (!file.is_open()) return "";
+    return fingerprint(string_view(file.data(), file.size()));
+}
+
+string ResultCache::key(const fs::path &filePath) const {
+    string content(file_fingerprint(filePath));
+    if (content.empty()) return "";
+    return fingerprint(content + "\n" + search);
+}
+
+bool ResultCache::load(const string &key, string &row, const fs::path &result) const {
+    if (!is_open() || key.empty()) return false;
+    ifstream stream(directory / (key + ".row"), ios::binary);
+    if (!stream.is_open()) return false;
+    ostringstream content;
+    content << stream.rdbuf();
+
+    error_code error;
+    if (!result.empty() && !fs::copy_file(directory / (key + ".fasta"), result, fs::copy_options::overwrite_existing, error)) return false;
+    row = content.str();
+    return true;
+}
+
+/** Renomme le fichier temporaire d'une entrée à son nom définitif, il est supprimé en cas d'échec. */
+static bool publish(const fs::path &path, const fs::path &temporary) {
+    error_code error;
+    fs::rename(temporary, path, error);
+    if (!error) return true;
+    fs::remove(temporary, error);
+    return false;
+}
+
+bool ResultCache::store(const string &key, string_view row, const fs::path &result) const {
+    if (!is_open() || key.empty()) return false;
+
+    error_code error;
+    if (!result.empty()) {
+        fs::path temporary(directory / (key + ".fasta.tmp"));
+        if (!fs::copy_file(result, temporary, fs::copy_options::overwrite_existing, error) || !publish(directory / (key + ".fasta"), temporary)) return false;
+    }
+
+    fs::path temporary(directory / (key + ".row.tmp"));
+    {
+        ofstream stream(temporary, ios::binary | ios::trunc);
+        stream.write(row.data(), (streamsize) row.size());
+        if (!stream.good()) return false;
+    }
+    return publish(directory / (key + ".row"), temporary);
+}
@@ -0,0 +1,101 @@
+//
+// Created by Florian Claisse on 17/10/2026.
+//
+
+#include "include/result_writer.h"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+ResultWriter::ResultWriter(size_t buffer_size, size_t pending_limit): buffer_size(buffer_size), pending_limit(pending_limit), pending_bytes(0), busy(false), stopping(false), failure(false) {
+    worker = thread(&ResultWriter::run, this);
+}
+
+ResultWriter::~ResultWriter() {
+    {
+        lock_guard<std::mutex> lock(mutex);
+        for (size_t i = 0; i < files.size(); i++) tasks.push_back({i, string(), Task::CLOSE, fs::path()});
+        stopping = true;
+    }
+    task_available.notify_one();
+    worker.join();
+}
+
+ResultWriter::Output ResultWriter::open(const fs::path &path) {
+    Output output;
+    {
+        lock_guard<std::mutex> lock(mutex);
+        output = files.size();
+        files.push_back(make_unique<File>());
+    }
+    push({output, string(), Task::OPEN, path});
+    return output;
+}
+
+void ResultWriter::write(Output output, string &&batch) {
+    if (batch.empty()) return;
+    push({output, move(batch), Task::WRITE, fs::path()});
+}
+
+void ResultWriter::close(Output output) {
+    push({output, string(), Task::CLOSE, fs::path()});
+}
+
+void ResultWriter::drain() {
+    unique_lock<std::mutex> lock(mutex);
+    space_available.wait(lock, [this] { return tasks.empty() && !busy; });
+}
+
+void ResultWriter::push(Task &&task) {
+    {
+        unique_lock<std::mutex> lock(mutex);
+        // Un lot plus gros que la limite passe seul, sinon il attendrait indéfiniment.
+        space_available.wait(lock, [this, &task] { return pending_bytes == 0 || pending_bytes + task.data.size() <= pending_limit; });
+        pending_bytes += task.data.size();
+        tasks.push_back(move(task));
+    }
+    task_available.notify_one();
+}
+
+void ResultWriter::run() {
+    while (true) {
+        Task task;
+        File *file;
+        {
+            unique_lock<std::mutex> lock(mutex);
+            task_available.wait(lock, [this] { return stopping || !tasks.empty(); });
+            if (tasks.empty()) return;
+            task = move(tasks.front());
+            tasks.pop_front();
+            file = files[task.output].get();
+            busy = true;
+        }
+
+        switch (task.kind) {
+            case Task::OPEN:
+                file->buffer = make_unique<char[]>(buffer_size);
+                file->stream.rdbuf()->pubsetbuf(file->buffer.get(), (streamsize) buffer_size);
+                file->stream.open(task.path, ios::trunc);
+                if (!file->stream.is_open()) failure = true;
+                break;
+            case Task::WRITE:
+                if (file->stream.is_open()) file->stream.write(task.data.data(), (streamsize) task.data.size());
+                if (file->stream.fail()) failure = true;
+                break;
+            case Task::CLOSE:
+                if (file->stream.is_open()) {
+                    file->stream.close();
+                    if (file->stream.fail()) failure = true;
+                }
+                file->buffer.reset();
+                break;
+        }
+
+        {
+            lock_guard<std::mutex> lock(mutex);
+            pending_bytes -= task.data.size();
+            busy = false;
+        }
+        space_available.notify_all();
+    }
+}
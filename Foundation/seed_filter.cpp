@@ -0,0 +1,59 @@
+//
+// Created by Florian Claisse on 17/10/2026.
+//
+
+#include <algorithm>
+
+#include "include/seed_filter.h"
+#include "include/fasta_search.h"
+
+using namespace std;
+
+fasta::SeedFilter::SeedFilter(const ContigSet &contigs, int maxErrorPercentage, bool both_strands) {
+    if (both_strands) reverse = detail::reverse_contigs(contigs);
+    for (size_t contig = 0; contig < contigs.size(); contig++) {
+        list.push_back({contig, '+', contigs.sequence(contig), 0, false});
+        if (both_strands && !reverse[contig].empty()) list.push_back({contig, '-', reverse[contig], 0, false});
+    }
+
+    for (size_t id = 0; id < list.size(); id++) {
+        Pattern &pattern(list[id]);
+        size_t size(pattern.sequence.size());
+        pattern.max_error = size * (size_t) maxErrorPercentage / 100;
+
+        // k + 1 morceaux, le dernier prend le reste de la division.
+        size_t pieces(pattern.max_error + 1), piece(size / pieces);
+        pattern.seeded = piece >= MIN_SEED;
+        if (!pattern.seeded) continue;
+        for (size_t p = 0; p < pieces; p++) {
+            size_t offset(p * piece), length(p + 1 == pieces ? size - offset : piece);
+            automaton.add(pattern.sequence.substr(offset, length));
+            seeds.push_back({id, offset});
+            longest = max(longest, length);
+        }
+    }
+    automaton.build();
+}
+
+void fasta::SeedFilter::candidates(string_view text, vector<Candidate> &candidates) const {
+    candidates.clear();
+    add_candidates(text, 0, text.size(), candidates);
+    sort_candidates(candidates);
+}
+
+void fasta::SeedFilter::add_candidates(string_view text, size_t base, size_t limit, vector<Candidate> &candidates) const {
+    automaton.search(text, [&](size_t id, size_t start) -> void {
+        const Candidate &seed(seeds[id]);
+        if (start < limit && base + start >= seed.start) candidates.push_back({seed.pattern, base + start - seed.start});
+    });
+}
+
+void fasta::SeedFilter::sort_candidates(vector<Candidate> &candidates) {
+    sort(candidates.begin(), candidates.end(), [](const Candidate &a, const Candidate &b) -> bool {
+        if (a.pattern != b.pattern) return a.pattern < b.pattern;
+        return a.start < b.start;
+    });
+    candidates.erase(unique(candidates.begin(), candidates.end(), [](const Candidate &a, const Candidate &b) -> bool {
+        return a.pattern == b.pattern && a.start == b.start;
+    }), candidates.end());
+}
@@ -0,0 +1,199 @@
+//
+// Created by Florian Claisse on 17/10/2026.
+//
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <vector>
+
+#include "include/sequence_file.h"
+#include "include/codon.h"
+#include "include/fasta_reader.h"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+static const char MAGIC[8] = {'C', 'T', 'G', 'S', 'E', 'Q', '1', '\0'};
+
+static uint64_t align8(uint64_t value) {
+    return (value + 7) & ~(uint64_t) 7;
+}
+
+/** Taille de la séquence de entry dans le fichier. */
+static uint64_t payload_size(const fasta::SequenceEntry &entry) {
+    return entry.packed ? (entry.length + 31) / 32 * 8 : entry.length;
+}
+
+fasta::SequenceFile::SequenceFile(const fs::path &filePath): mapped(filePath), data(mapped.data()), bytes(mapped.size()), header(nullptr), entries(nullptr), order(nullptr) {
+    open();
+}
+
+fasta::SequenceFile::SequenceFile(const char *data, size_t size): data(data), bytes(size), header(nullptr), entries(nullptr), order(nullptr) {
+    open();
+}
+
+void fasta::SequenceFile::open() {
+    if (bytes < sizeof(SequenceHeader) || !has_magic(data, bytes)) return;
+    const SequenceHeader *candidate((const SequenceHeader*) data);
+    uint64_t count(candidate->record_count);
+    if (candidate->size != bytes || count > bytes / sizeof(SequenceEntry)) return;
+    if (candidate->records_offset < sizeof(SequenceHeader) || candidate->records_offset % 8 != 0 || !MappedFile::inside(candidate->records_offset, count * sizeof(SequenceEntry), bytes)) return;
+    if (candidate->order_offset % 8 != 0 || !MappedFile::inside(candidate->order_offset, count * sizeof(uint64_t), bytes)) return;
+    if (candidate->names_offset > candidate->data_offset || candidate->data_offset > bytes) return;
+
+    // Les entrées et l'ordre sont vérifiés une fois ici : les lectures suivantes ne sortent pas du fichier.
+    const SequenceEntry *table((const SequenceEntry*) (data + candidate->records_offset));
+    uint64_t names_size(candidate->data_offset - candidate->names_offset);
+    for (size_t i = 0; i < count; i++) {
+        const SequenceEntry &current(table[i]);
+        if (!MappedFile::inside(current.name_offset, current.name_length, names_size)) return;
+        if (current.packed > 1 || current.length / 4 > bytes) return;
+        if (current.sequence_offset < candidate->data_offset || current.sequence_offset % 8 != 0 || !MappedFile::inside(current.sequence_offset, payload_size(current), bytes)) return;
+    }
+    const uint64_t *sorted((const uint64_t*) (data + candidate->order_offset));
+    for (size_t i = 0; i < count; i++) {
+        if (sorted[i] >= count) return;
+    }
+
+    header = candidate;
+    entries = table;
+    order = sorted;
+    checked.assign(count, UNCHECKED);
+}
+
+bool fasta::SequenceFile::has_magic(const char *data, size_t size) {
+    return size >= sizeof(MAGIC) && memcmp(data, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+uint64_t fasta::SequenceFile::checksum(string_view sequence, uint64_t hash) {
+    for (const char c : sequence) {
+        hash ^= (unsigned char) c;
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+size_t fasta::SequenceFile::index_at(size_t offset) const {
+    if (header == nullptr || offset < header->records_offset) return size();
+    size_t relative(offset - header->records_offset);
+    if (relative % sizeof(SequenceEntry) != 0) return size();
+    return min(relative / sizeof(SequenceEntry), size());
+}
+
+size_t fasta::SequenceFile::find(string_view name) const {
+    const uint64_t *end(order + size());
+    const uint64_t *found(lower_bound(order, end, name, [this](uint64_t index, string_view value) -> bool { return this->name(index) < value; }));
+    return found != end && this->name(*found) == name ? *found : size();
+}
+
+string_view fasta::SequenceFile::sequence(size_t index, size_t begin, size_t count, string &buffer) const {
+    const SequenceEntry &current(entries[index]);
+    begin = min<size_t>(begin, current.length);
+    count = min<size_t>(count, current.length - begin);
+    const char *payload(data + current.sequence_offset);
+    if (!current.packed) return {payload + begin, count};
+
+    static const char bases[] = "ACGT";
+    const uint64_t *words((const uint64_t*) payload);
+    buffer.resize(count);
+    for (size_t i = 0, position = begin; i < count;) {
+        // Un mot est chargé une fois pour ses 32 bases.
+        uint64_t word(words[position / 32] >> (2 * (position % 32)));
+        for (size_t n = min(count - i, 32 - position % 32); n > 0; n--, i++, position++, word >>= 2) buffer[i] = bases[word & 3];
+    }
+    return buffer;
+}
+
+bool fasta::SequenceFile::verify(size_t index) const {
+    if (checked[index] == UNCHECKED) {
+        // Une séquence sur 2 bits est décodée par blocs : la vérification ne dépend pas de la taille de l'enregistrement.
+        static const size_t BLOCK = 1 << 16;
+        string buffer;
+        uint64_t hash(checksum(string_view()));
+        for (size_t begin = 0; begin < length(index); begin += BLOCK) hash = checksum(sequence(index, begin, BLOCK, buffer), hash);
+        checked[index] = hash == entries[index].checksum ? VALID : CORRUPTED;
+    }
+    return checked[index] == VALID;
+}
+
+/** Indique si sequence peut être codée sur 2 bits sans perte. */
+static bool is_acgt(string_view sequence) {
+    for (const char c : sequence) {
+        if (c != 'A' && c != 'C' && c != 'G' && c != 'T') return false;
+    }
+    return true;
+}
+
+int fasta::SequenceFile::write(const fs::path &filePath, const fs::path &output, bool packed) {
+    // Premier passage : table des enregistrements et en-têtes, sans garder les séquences.
+    vector<SequenceEntry> table;
+    string names;
+    {
+        Reader reader(filePath);
+        if (!reader.is_open()) return EXIT_FAILURE;
+        Record record;
+        while (reader.next(record)) {
+            SequenceEntry current{};
+            current.name_offset = names.size();
+            current.name_length = record.header.size();
+            current.length = record.sequence.size();
+            current.checksum = SequenceFile::checksum(record.sequence);
+            current.packed = packed && !record.sequence.empty() && is_acgt(record.sequence);
+            names += record.header;
+            table.push_back(current);
+        }
+    }
+
+    vector<uint64_t> order(table.size());
+    iota(order.begin(), order.end(), 0);
+    stable_sort(order.begin(), order.end(), [&names, &table](uint64_t a, uint64_t b) -> bool {
+        return string_view(names).substr(table[a].name_offset, table[a].name_length) < string_view(names).substr(table[b].name_offset, table[b].name_length);
+    });
+
+    SequenceHeader header{};
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.record_count = table.size();
+    header.records_offset = sizeof(SequenceHeader);
+    header.order_offset = header.records_offset + table.size() * sizeof(SequenceEntry);
+    header.names_offset = header.order_offset + order.size() * sizeof(uint64_t);
+    header.data_offset = align8(header.names_offset + names.size());
+    uint64_t offset(header.data_offset);
+    for (auto &current : table) {
+        current.sequence_offset = offset;
+        offset = align8(offset + payload_size(current));
+    }
+    header.size = offset;
+
+    ofstream outputFile;
+    outputFile.open(output, ios::binary | ios::trunc);
+    if (!outputFile.is_open()) return EXIT_FAILURE;
+    static const char padding[8] = {};
+    outputFile.write((const char*) &header, sizeof(SequenceHeader));
+    outputFile.write((const char*) table.data(), (streamsize) (table.size() * sizeof(SequenceEntry)));
+    outputFile.write((const char*) order.data(), (streamsize) (order.size() * sizeof(uint64_t)));
+    outputFile.write(names.data(), (streamsize) names.size());
+    outputFile.write(padding, (streamsize) (header.data_offset - header.names_offset - names.size()));
+
+    // Second passage : les séquences, dans l'ordre de la table.
+    Reader reader(filePath);
+    Record record;
+    vector<uint64_t> words;
+    for (size_t i = 0; i < table.size() && reader.next(record); i++) {
+        const SequenceEntry &current(table[i]);
+        if (record.sequence.size() != current.length) return EXIT_FAILURE;
+        if (current.packed) {
+            words.assign((current.length + 31) / 32, 0);
+            for (size_t position = 0; position < current.length; position++) {
+                words[position / 32] |= (uint64_t) codon::BASE_CODES[(unsigned char) record.sequence[position]] << (2 * (position % 32));
+            }
+            outputFile.write((const char*) words.data(), (streamsize) (words.size() * sizeof(uint64_t)));
+        }
+        else outputFile.write(record.sequence.data(), (streamsize) record.sequence.size());
+        outputFile.write(padding, (streamsize) (align8(payload_size(current)) - payload_size(current)));
+    }
+    outputFile.close();
+
+    return outputFile.fail() ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,128 @@
+//
+// Created by Florian Claisse on 17/10/2026.
+//
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <sys/resource.h>
+
+#include "include/stats.h"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+stats::Counters &stats::Counters::operator+=(const Counters &other) {
+    bytes += other.bytes;
+    records += other.records;
+    positions += other.positions;
+    hits += other.hits;
+    return *this;
+}
+
+stats::Counters &stats::local() {
+    thread_local Counters counters;
+    return counters;
+}
+
+stats::Report::Report(string command): command(move(command)), begin(chrono::steady_clock::now()) {}
+
+void stats::Report::add_phase(const string &name, double seconds) {
+    lock_guard<std::mutex> lock(mutex);
+    phases.emplace_back(name, seconds);
+}
+
+void stats::Report::add_file(FileStats file) {
+    lock_guard<std::mutex> lock(mutex);
+    files.push_back(move(file));
+}
+
+/** Clés de premier niveau écrites par Report::write : une valeur de même nom en ferait une clé en double. */
+static const array<const char*, 6> RESERVED{"command", "wall_seconds", "peak_rss_kb", "phases", "totals", "files"};
+
+bool stats::Report::set(const string &name, uint64_t value) {
+    if (find(RESERVED.begin(), RESERVED.end(), name) != RESERVED.end()) return false;
+    lock_guard<std::mutex> lock(mutex);
+    values.emplace_back(name, value);
+    return true;
+}
+
+/** Chaîne JSON entre guillemets. */
+static string quoted(const string &value) {
+    ostringstream result;
+    result << '"';
+    for (const char c : value) {
+        if (c == '"' || c == '\\') result << '\\' << c;
+        else if ((unsigned char) c < 0x20) result << "\\u" << hex << setw(4) << setfill('0') << (int) c << dec;
+        else result << c;
+    }
+    result << '"';
+    return result.str();
+}
+
+static void write_counters(ostream &output, const stats::Counters &counters, double seconds) {
+    output << "\"bytes\": " << counters.bytes
+    << ", \"records\": " << counters.records
+    << ", \"positions\": " << counters.positions
+    << ", \"hits\": " << counters.hits
+    << ", \"mb_per_s\": " << (seconds > 0 ? (double) counters.bytes / (1024.0 * 1024.0) / seconds : 0.0);
+}
+
+int stats::Report::write(const fs::path &path) const {
+    lock_guard<std::mutex> lock(mutex);
+    double wall(chrono::duration<double>(chrono::steady_clock::now() - begin).count());
+
+    vector<FileStats> sorted(files);
+    sort(sorted.begin(), sorted.end(), [](const FileStats &a, const FileStats &b) -> bool { return a.name < b.name; });
+    Counters total;
+    double scan_seconds(0);
+    for (const auto &file : sorted) {
+        total += file.counters;
+        scan_seconds += file.seconds;
+    }
+
+    ofstream output;
+    output.open(path, ios::trunc);
+    if (!output.is_open()) return EXIT_FAILURE;
+
+    output << fixed << setprecision(6) << "{" << endl
+    << "  \"command\": " << quoted(command) << "," << endl
+    << "  \"wall_seconds\": " << wall << "," << endl
+    << "  \"peak_rss_kb\": " << peak_rss_kb() << "," << endl;
+    for (const auto &value : values) output << "  " << quoted(value.first) << ": " << value.second << "," << endl;
+
+    output << "  \"phases\": [";
+    for (size_t i = 0; i < phases.size(); i++) {
+        output << (i ? "," : "") << endl << "    {\"name\": " << quoted(phases[i].first) << ", \"seconds\": " << phases[i].second << "}";
+    }
+    output << endl << "  ]," << endl;
+
+    output << "  \"totals\": {";
+    write_counters(output, total, scan_seconds);
+    output << "}," << endl;
+
+    output << "  \"files\": [";
+    for (size_t i = 0; i < sorted.size(); i++) {
+        output << (i ? "," : "") << endl << "    {\"name\": " << quoted(sorted[i].name) << ", \"seconds\": " << sorted[i].seconds << ", ";
+        write_counters(output, sorted[i].counters, sorted[i].seconds);
+        output << "}";
+    }
+    output << endl << "  ]" << endl << "}" << endl;
+
+    output.close();
+    return output.fail() ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+stats::ScopedTimer::ScopedTimer(Report *report, string name): report(report), name(move(name)) {}
+
+stats::ScopedTimer::~ScopedTimer() {
+    if (report != nullptr) report->add_phase(name, elapsed());
+}
+
+uint64_t stats::peak_rss_kb() {
+    struct rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return (uint64_t) usage.ru_maxrss;
+}
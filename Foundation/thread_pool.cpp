@@ -0,0 +1,74 @@
+//
+// Created by Florian Claisse on 17/10/2026.
+//
+
+#include "include/thread_pool.h"
+
+using namespace std;
+
+ThreadPool::ThreadPool(size_t threads): next_queue(0), pending(0), queued(0), stopping(false) {
+    if (threads == 0) threads = 1;
+    for (size_t i = 0; i < threads; i++) queues.push_back(make_unique<Queue>());
+    for (size_t i = 0; i < threads; i++) workers.emplace_back(&ThreadPool::work, this, i);
+}
+
+ThreadPool::~ThreadPool() {
+    wait();
+    {
+        lock_guard<mutex> lock(state_mutex);
+        stopping = true;
+    }
+    work_available.notify_all();
+    for (auto &worker : workers) worker.join();
+}
+
+void ThreadPool::submit(function<void()> task) {
+    size_t index(next_queue.fetch_add(1) % queues.size());
+    {
+        lock_guard<mutex> lock(queues[index]->mutex);
+        queues[index]->tasks.push_back(move(task));
+    }
+    {
+        lock_guard<mutex> lock(state_mutex);
+        pending++;
+        queued++;
+    }
+    work_available.notify_one();
+}
+
+void ThreadPool::wait() {
+    unique_lock<mutex> lock(state_mutex);
+    all_done.wait(lock, [this] { return pending == 0; });
+}
+
+bool ThreadPool::pop(size_t index, function<void()> &task) {
+    // D'abord sa propre file, puis vol dans celles des autres workers.
+    for (size_t i = 0; i < queues.size(); i++) {
+        Queue &queue(*queues[(index + i) % queues.size()]);
+        lock_guard<mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) continue;
+        task = move(queue.tasks.front());
+        queue.tasks.pop_front();
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::work(size_t index) {
+    while (true) {
+        {
+            unique_lock<mutex> lock(state_mutex);
+            work_available.wait(lock, [this] { return stopping || queued > 0; });
+            if (queued == 0) return;
+            queued--;
+        }
+
+        // Une tâche est réservée par le décompte : elle finira par être trouvée dans une des files.
+        function<void()> task;
+        while (!pop(index, task)) this_thread::yield();
+        task();
+
+        lock_guard<mutex> lock(state_mutex);
+        if (--pending == 0) all_done.notify_all();
+    }
+}
@@ -0,0 +1,70 @@
+//
+// Created by Florian Claisse on 17/10/2026.
+//
+
+#include <algorithm>
+
+#include "../Foundation/include/kmer_spectrum.h"
+#include "../Foundation/include/fasta.h"
+#include "../Foundation/include/directory.h"
+#include "../Foundation/include/thread_pool.h"
+#include "kmer_count.h"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+/** Écrit les k-mers d'au moins min_count occurrences de table dans le format demandé. */
+static int write_spectrum(const program_option::KmerCount &options, const kmer_spectrum::Table &table, const fs::path &output) {
+    vector<kmer_spectrum::Entry> entries(table.sorted(options.min_count));
+    int status(options.binary ? kmer_spectrum::write_binary(output, entries, options.k, options.min_count) : kmer_spectrum::write_tsv(output, entries, options.k));
+    if (status != EXIT_SUCCESS) cout << "Impossible d'écrire le spectre : " << output << endl;
+    return status;
+}
+
+int kmer_count::start(const program_option::KmerCount &options) {
+    if (!fs::is_directory(options.output)) {
+        cout << "Path : " << options.output << "n'est pas un dossier" << endl;
+        return EXIT_FAILURE;
+    }
+    if (options.k == 0 || options.k > kmer_spectrum::MAX_K) {
+        cout << "La taille des k-mers doit être comprise entre 1 et " << kmer_spectrum::MAX_K << "." << endl;
+        return EXIT_FAILURE;
+    }
+
+    vector<fs::path> files;
+    if (fs::is_directory(options.inputB)) files = fasta::input_files(options.inputB);
+    else if (fasta::is_input_file(options.inputB)) files.push_back(options.inputB);
+    else {
+        cout << "Path : " << options.inputB << "n'est pas un dossier ou un fichier fasta" << endl;
+        return EXIT_FAILURE;
+    }
+
+    // Les fichiers sont comptés l'un après l'autre, chacun par tous les workers.
+    string extension(options.binary ? ".bin" : ".tsv");
+    ThreadPool pool(options.threads);
+    kmer_spectrum::Table total;
+    for (const auto &file : files) {
+        if (!options.per_file) {
+            if (kmer_spectrum::count(file, options.k, total, pool) != EXIT_SUCCESS) {
+                cout << "Impossible de lire : " << file << endl;
+                return EXIT_FAILURE;
+            }
+            continue;
+        }
+
+        kmer_spectrum::Table table;
+        if (kmer_spectrum::count(file, options.k, table, pool) != EXIT_SUCCESS) {
+            cout << "Impossible de lire : " << file << endl;
+            return EXIT_FAILURE;
+        }
+        fs::path output(options.output.string().append("/" + directory::fileNameWithoutExtension(file) + "-kmers" + extension));
+        if (write_spectrum(options, table, output) != EXIT_SUCCESS) return EXIT_FAILURE;
+
+        // Le spectre du dossier est la somme de ceux des fichiers.
+        vector<kmer_spectrum::Entry> entries(table.sorted(1));
+        total.reserve(entries.size());
+        for (const auto &entry : entries) total.add(entry.first, entry.second);
+    }
+
+    return write_spectrum(options, total, options.output.string().append("/kmers" + extension));
+}
@@ -0,0 +1,14 @@
+//
+// Created by Florian Claisse on 17/10/2026.
+//
+
+#ifndef CONTIG_KMER_COUNT_H
+#define CONTIG_KMER_COUNT_H
+
+#include "../Foundation/include/program_option.h"
+
+namespace kmer_count {
+    int start(const program_option::KmerCount &options);
+}
+
+#endif //CONTIG_KMER_COUNT_H